@@ -15,7 +15,8 @@
  */
 enum
 {
-  KILLED = -12,                 /*!< Process has been killed */
+  STACKOVF = -13,               /*!< Stack overflow */
+  KILLED,                       /*!< Process has been killed */
   NOTFOUND,                     /*!< These are not the droid you are looking for */
   OUTOMEM,                      /*!< Out of memory */
   UNKNPID,                      /*!< Unknown pid (process identifier) */
@@ -9,10 +9,26 @@
 #ifndef __MESSAGE_H
 #define __MESSAGE_H
 
+/*
+ * Priorities of the messages: a receive takes the pending message of
+ * highest priority first, the oldest one among equals. send uses BAS_MPRI,
+ * so that a message sent with sendp and a higher priority passes them.
+ */
 #define MIN_MPRI 0
 #define MAX_MPRI 30
 #define BAS_MPRI 15
 
+/*
+ * Buffers of the kernel for the messages of type BUF_T, see buf_alloc
+ */
+#ifndef MSG_BUF_SIZE
+#define MSG_BUF_SIZE 1024
+#endif
+
+#ifndef MSG_BUFS
+#define MSG_BUFS 32
+#endif
+
 /**
  * \brief enum of all the types of data a user can send using messages functions.
 It must be specified when sending or receiving messages.
@@ -21,6 +37,7 @@ typedef enum
 {
   INT_T,                        /*!< Type integer */
   CHAR_PTR,                     /*!< Type char* */
+  BUF_T,                        /*!< Buffer of buf_alloc, given without a copy: the receive writes its address in a void* */
   //OTHER_T
 } msg_t;
 
@@ -51,7 +68,7 @@ typedef struct
 
 /**
  * \fn send(void* data, int pid)
- * \brief Send the data to the process 'pid'.
+ * \brief Send the data to the process 'pid' with priority BAS_MPRI.
  *
  * \param data the data to send
  * \param pid the pid of the receiver
@@ -73,24 +90,25 @@ int             sendp(void *data, msg_t tdata, int pid, int prio);
 
 /**
  * \fn int recv(void* data, msg_t tdata, int timeout)
- * \brief Receives a message of type 'tdata'.
+ * \brief Receives the message of type 'tdata' of highest priority.
  *
  * \param data the data to send
  * \param tdata data type of the 'data' variable
- * \param timeout time to wait before stopping receive process
- * \return the pid of the receiver or an error code otherwise
+ * \param timeout time to wait for the message in ms, 0 or less to wait until it comes
+ * \return the pid of the sender, NOTFOUND at the end of the timeout, or an error code otherwise
  */
 int             recv(void *data, msg_t tdata, int timeout);
 
 /**
  * \fn int recv_from_pid(void* data, msg_t tdata, int pid, int timeout)
- * \brief Receives a message of type 'tdata' from the specific process 'pid'.
+ * \brief Receives the message of type 'tdata' of highest priority from the
+ * specific process 'pid'.
  *
  * \param data the data to send
  * \param tdata data type of the 'data' variable
  * \param pid the pid of the receiver
- * \param timeout time to wait before stopping receive process
- * \return the pid of the receiver or an error code otherwise
+ * \param timeout time to wait for the message in ms, 0 or less to wait until it comes
+ * \return the pid of the sender, NOTFOUND at the end of the timeout, or an error code otherwise
  */
 int             recv_from_pid(void *data, msg_t tdata, int pid, int timeout);
 
@@ -101,10 +119,57 @@ int             recv_from_pid(void *data, msg_t tdata, int pid, int timeout);
  * \param data the data to send
  * \param tdata data type of the 'data' variable
  * \param pri the priority of the message to wait
- * \param timeout time to wait before stopping receive process
- * \return the pid of the receiver or an error code otherwise
+ * \param timeout time to wait for the message in ms, 0 or less to wait until it comes
+ * \return the pid of the sender, NOTFOUND at the end of the timeout, or an error code otherwise
  */
 int             recv_fromp_pri(void *data, msg_t tdata, int pri, int timeout);
 
+/**
+ * \fn int call(int pid, int req, int *reply)
+ * \brief Send the request 'req' to the server 'pid' and wait for its reply.
+ * A server waiting in reply_and_wait runs at once.
+ *
+ * \param pid the pid of the server
+ * \param req the request
+ * \param reply where to write the reply
+ * \return OMGROXX, UNKNPID if the server terminates before it replies, or
+ * an error code otherwise
+ */
+int             call(int pid, int req, int *reply);
+
+/**
+ * \fn int reply_and_wait(int client, int rep, int *req)
+ * \brief Reply 'rep' to the client 'client', then wait for the next request.
+ * The client runs at once if no request is pending.
+ *
+ * \param client the pid of the client, less than 0 to reply to nobody
+ * \param rep the reply
+ * \param req where to write the next request, NULL to reply without waiting
+ * \return the pid of the client of the next request, OMGROXX if req is
+ * NULL, or an error code otherwise
+ */
+int             reply_and_wait(int client, int rep, int *req);
+
+
+/**
+ * \fn void* buf_alloc()
+ * \brief Take a buffer of MSG_BUF_SIZE bytes from the kernel.
+ *
+ * Sent with the type BUF_T, the buffer is not copied: the receiver gets
+ * its address and owns it, the sender must not use it any more. The owner
+ * gives it back with buf_free, or when it terminates.
+ *
+ * \return the address of the buffer, NULL if there is no free buffer
+ */
+void           *buf_alloc();
+
+/**
+ * \fn int buf_free(void* buf)
+ * \brief Give back a buffer of buf_alloc.
+ *
+ * \param buf the address of the buffer
+ * \return OMGROXX, or INVARG if the process does not own this buffer
+ */
+int             buf_free(void *buf);
 
 #endif //__MESSAGE_H
@@ -14,7 +14,31 @@
 #define BAS_PRI 21
 #define MAX_ARG 4
 #define ARG_SIZE 60
+
+/**
+ * @brief Number of processes the system can hold. The memory of the kernel
+ * grows linearly with it, ex: make KCONFIG=-DMAXPCB=1024
+ */
+#ifndef MAXPCB
 #define MAXPCB 40
+#endif
+
+/**
+ * @brief Number of supervised processes listed in a pcbinfo
+ */
+#define PINFO_SUPERVISED 16
+
+/**
+ * @brief Value of pcbinfo.waitfor for a process waiting for any of its
+ * children, see wait_any
+ */
+#define WAIT_ANY -2
+
+/**
+ * @brief Value of pcbinfo.waitfor for a process waiting for one of a set of
+ * its children, see wait_set
+ */
+#define WAIT_SET -3
 
 #include <stdlib.h>
 
@@ -30,7 +54,8 @@ typedef struct
   int             pid;          /*!< Process identifier. */
   char            name[ARG_SIZE];       /*!< Process name. */
   int             pri;          /*!< Process priority. */
-  int             supervised[MAXPCB];   /*!< List of supervised processes. */
+  int             supervised[PINFO_SUPERVISED];   /*!< First supervised processes, -1 after the last one. */
+  int             nb_supervised;        /*!< Number of supervised processes, even the ones not listed. */
   int             supervisor;   /*!< supervisor. */
   int             state;        /*!< Current state of the process */
   int             sleep;        /*!< Time to sleep, if state == SLEEPING */
@@ -38,8 +63,107 @@ typedef struct
   int             error;        /*!< Last error the process encountered. */
   bool            empty;        /*!< is this pcb empty ? */
   int             nb_msg;       /*!< number of messages */
+  int             epri;         /*!< Effective priority, the one used by the scheduler */
+  unsigned int    ready_date;   /*!< Value of count when it became READY */
+  unsigned int    run_date;     /*!< Value of count when it became RUNNING */
+  unsigned int    run_time;     /*!< Time spent running, in us */
+  unsigned int    wait_time;    /*!< Time spent ready but not running, in us */
+  unsigned int    vol_switch;   /*!< Times it gave the cpu (block, sleep, wait) */
+  unsigned int    invol_switch; /*!< Times it was preempted */
+  unsigned int    stack_size;   /*!< Size of the stack, in bytes */
+  unsigned int    stack_peak;   /*!< Most of the stack ever used, in bytes */
 } pcbinfo;
 
+/**
+ * @brief Size of an argblock, in bytes. The arguments of a process take at
+ * most this size.
+ */
+#define ARG_BLOCK 256
+
+/**
+ * @brief Size of the header of an argblock: size and argc
+ */
+#define ARG_HEADER 8
+
+/**
+ * \struct argblock
+ * \brief Packed arguments of a process.
+ *
+ * Each argument is its length on one byte, its chars and a '\0', right after
+ * the previous one. The first one is the name of the program. The kernel
+ * copies the block once, by words, to the top of the stack of the new
+ * process, which gets it as argv. Build it with args_init and args_add.
+ */
+typedef struct
+{
+  int             size;         /*!< Bytes used, header included */
+  int             argc;         /*!< Number of arguments, name included */
+  char            data[ARG_BLOCK - ARG_HEADER]; /*!< The arguments */
+} argblock;
+
+/**
+ * \struct spawninfo
+ * \brief Processes to create with fourchette_many.
+ *
+ * The process i gets the block args[i % nargs]: one block gives the same
+ * arguments to all of them.
+ */
+typedef struct
+{
+  char           *name;         /*!< Name of the program */
+  int             prio;         /*!< Priority of the processes */
+  int             n;            /*!< Number of processes to create */
+  argblock       *args;         /*!< Blocks of arguments */
+  int             nargs;        /*!< Number of blocks, 0 for no arguments */
+  int            *pids;         /*!< Array of n pids to fill */
+} spawninfo;
+
+/**
+ * @brief Size of the name in a psinfo, with the final '\0'
+ */
+#define PS_NAME 16
+
+/**
+ * \struct psinfo
+ * \brief Compact copy of a process, for ps.
+ *
+ * get_ps_info fills an array of them with a single syscall.
+ */
+typedef struct
+{
+  int             pid;          /*!< Process identifier. */
+  char            name[PS_NAME];        /*!< Process name, cut to PS_NAME - 1 chars. */
+  int             state;        /*!< Current state of the process */
+  int             pri;          /*!< Process priority. */
+  int             epri;         /*!< Effective priority, the one used by the scheduler */
+  unsigned int    run_time;     /*!< Time spent running, in us */
+  unsigned int    wait_time;    /*!< Time spent ready but not running, in us */
+  unsigned int    vol_switch;   /*!< Times it gave the cpu (block, sleep, wait) */
+  unsigned int    invol_switch; /*!< Times it was preempted */
+  int             nb_msg;       /*!< Number of messages in its mailbox */
+} psinfo;
+
+/**
+ * @brief Number of buckets of the latency histogram
+ */
+#define LAT_BUCKETS 20
+
+/**
+ * \struct schedinfo
+ * \brief Statistics of the scheduler.
+ *
+ * latency[i] counts the processes that waited between 2^i and 2^(i+1) us
+ * from the time they became ready to the time they ran (less than 2 us for
+ * latency[0], more than 2^(LAT_BUCKETS-1) us for the last one).
+ */
+typedef struct
+{
+  unsigned int    switches;     /*!< Number of context switches */
+  unsigned int    latency[LAT_BUCKETS];   /*!< Histogram of the ready to run latency */
+  unsigned int    busy_time;    /*!< Time a process was running, in ms */
+  unsigned int    idle_time;    /*!< Time the cpu waited in the idle loop, in ms */
+} schedinfo;
+
 #ifndef __PROCESS_STATE
 #define __PROCESS_STATE
 enum
@@ -51,6 +175,10 @@ enum
   WAITING_IO,
   DOING_IO,
   WAITING_PCB,
+  WAITING_MSG,
+  WAITING_CALL,
+  CALLING,
+  WAITING_REPLY,
   OMG_ZOMBIE
 };
 #endif
@@ -59,12 +187,33 @@ enum
  * \fn char* get_arg(char* argv[], int i)
  * \brief Return the argument i from the char* array of arguments.
  *
- * \param argv the array of arguments
+ * \param argv the array of arguments, an argblock
  * \param i the index of the char* that will be returned
- * \return the argument i
+ * \return the argument i, an empty string if there is no argument i
  */
 char           *get_arg(char *argv[], int i);
 
+ /**
+ * \fn int args_init(argblock *args, char *name)
+ * \brief Start a block of arguments with the name of the program.
+ *
+ * \param args the block to fill
+ * \param name the name of the program
+ * \return the error identifier in case of any failure
+ */
+int             args_init(argblock * args, char *name);
+
+ /**
+ * \fn int args_add(argblock *args, char *arg)
+ * \brief Add an argument at the end of a block of arguments.
+ *
+ * \param args the block to fill
+ * \param arg the argument, at most 255 chars
+ * \return the error identifier in case of any failure (OUTOMEM if the block
+is full)
+ */
+int             args_add(argblock * args, char *arg);
+
  /**
  * \fn int exit(int status)
  * \brief Kill the current process.
@@ -120,6 +269,26 @@ variable with its exit code.
  */
 int             wait(int pid, int *status);
 
+ /**
+ * \fn int wait_any(int *status)
+ * \brief Wait for any child to exit, and set the status variable with its exit code. A child that already exited is taken at once, otherwise the process blocks until one exits.
+ *
+ * \param status the value of the waited process return code, can be NULL
+ * \return the pid of the child, NOTFOUND if the process has no child
+ */
+int             wait_any(int *status);
+
+ /**
+ * \fn int wait_set(int *pids, int n, int *status)
+ * \brief Wait for one of the children of the array to exit, and set the status variable with its exit code. The pids that are not children of the process are ignored.
+ *
+ * \param pids the array of the pids to wait for
+ * \param n the number of pids
+ * \param status the value of the waited process return code, can be NULL
+ * \return the pid of the child, NOTFOUND if none of the pids is a child
+ */
+int             wait_set(int *pids, int n, int *status);
+
  /**
  * \fn int fourchette(char *name, int argc, char *argv[])
  * \brief Creates a new process with the program identified by its name 'name'. The program must be stored in the program list of the OS.
@@ -132,6 +301,31 @@ int             wait(int pid, int *status);
  */
 int             fourchette(char *name, int prio, int argc, char *argv[]);
 
+ /**
+ * \fn int fourchette_args(argblock *args, int prio)
+ * \brief Creates a new process with a block of arguments. The first argument is the name of the program.
+ *
+ * \param args the arguments, built with args_init and args_add
+ * \param prio the priority of the process to create
+ * \return the process pid (>0) or an negative error in case of any failure
+ */
+int             fourchette_args(argblock * args, int prio);
+
+ /**
+ * \fn int fourchette_many(char *name, int prio, int n, argblock *args, int nargs, int *pids)
+ * \brief Creates n processes of the same program with a single syscall. The process i gets the arguments args[i % nargs].
+ *
+ * \param name the name of the program
+ * \param prio the priority of the processes
+ * \param n the number of processes
+ * \param args the blocks of arguments, their first argument is argv[0]
+ * \param nargs the number of blocks, 0 for no arguments
+ * \param pids the array of n pids to fill
+ * \return the number of processes created or an negative error. If it is less than n, the next pid is the error.
+ */
+int             fourchette_many(char *name, int prio, int n, argblock * args,
+                                int nargs, int *pids);
+
  /**
  * \fn int get_proc_info(int pid)
  * \brief Fill the pcb_info structure given in parameter with the pcb information. Only
@@ -143,6 +337,16 @@ not critical information is given to the user.
  */
 int             get_proc_info(int pid, pcbinfo * res);
 
+ /**
+ * \fn int get_sched_info(schedinfo * res)
+ * \brief Fill the schedinfo structure given in parameter with the statistics
+of the scheduler.
+ *
+ * \param res the schedinfo structure to fill
+ * \return the error identifier in case of any failure
+ */
+int             get_sched_info(schedinfo * res);
+
  /**
  * \fn int chg_pri(int pid, int newprio)
  * \brief Changes the priority of the process from the old one to the new priority ’prio’.
@@ -170,4 +374,15 @@ int             get_pid(void);
  */
 int             get_ps(int *pid);
 
+ /**
+ * \fn int get_ps_info(psinfo *res, int max)
+ * \brief Fill the psinfo array with all the processes, in one syscall.
+ *
+ * \param res the array of psinfo to fill
+ * \param max the size of the array
+ * \return the number of psinfo filled, or the error identifier in case of any
+failure
+ */
+int             get_ps_info(psinfo * res, int max);
+
 #endif //__PROCESS_H
@@ -0,0 +1,770 @@
+/**
+ * @file bench.c
+ * @brief Micro benchmarks of the scheduler and the IPC, run on the host
+ *
+ * Each benchmark runs n iterations of an operation, n grows until the run
+ * lasts BENCH_MIN_TIME. The kernel state is reset before each run. Only the
+ * time between bench_start and bench_stop counts, they can be called more
+ * than once.
+ */
+
+#include <types.h>
+#include <errno.h>
+#include <string.h>
+#include <message.h>
+#include <process.h>
+#include "../kernel/kernel.h"
+#include "../kernel/kprocess.h"
+#include "../kernel/kprocess_list.h"
+#include "../kernel/kscheduler.h"
+#include "../kernel/ksleep.h"
+#include "../kernel/kmsg.h"
+#include "../kernel/kbuf.h"
+#include "../kernel/ksyscall.h"
+#include "../kernel/kstat.h"
+#include "../kernel/ktimer.h"
+#include "../kernel/asm.h"
+#include "hal.h"
+
+#define BENCH_MIN_TIME 200000000        /* ns */
+#define BENCH_MAX_ITER 100000000
+
+/**
+ * @brief A benchmark
+ */
+typedef struct
+{
+  char           *name;         /*!< name of the benchmark */
+  void            (*fn) (uint32_t n, uint32_t arg);     /*!< run n iterations */
+  uint32_t        arg;          /*!< parameter, usually a number of processes */
+} bench;
+
+/*
+ * Time measured by the current run
+ */
+static uint32_t bench_t0;
+static uint32_t bench_time;
+
+/*
+ * The timed part of a benchmark is between bench_start and bench_stop
+ */
+static void
+bench_start()
+{
+  bench_t0 = hal_now_ns();
+}
+
+static void
+bench_stop()
+{
+  bench_time += hal_now_ns() - bench_t0;
+}
+
+/*
+ * Reset the kernel, like kinit does
+ */
+static void
+bench_boot()
+{
+  rq_reset(&rqready);
+  pls_reset(&plsrunning);
+  pls_reset(&plswaiting);
+  pls_reset(&plssleeping);
+  pls_reset(&plsterminate);
+
+  kstat_reset();
+  reset_next_pid();
+  reset_used_stack();
+  init_mem();
+
+  set_current_pcb(NULL);
+  p_error = &kerror;
+
+  ktimer_init();
+}
+
+/*
+ * Create n processes of priority pri, and run the first one
+ */
+static void
+bench_spawn(uint32_t n, uint32_t pri)
+{
+  uint32_t        i;
+
+  for (i = 0; i < n; i++)
+    create_proc("increment", pri, 0, NULL);
+
+  schedule();
+}
+
+/*
+ * Round robin between arg processes of the same priority
+ */
+static void
+bm_schedule_rr(uint32_t n, uint32_t arg)
+{
+  uint32_t        i;
+
+  bench_spawn(arg, BAS_PRI);
+
+  bench_start();
+  for (i = 0; i < n; i++)
+  {
+    sched_expire(get_current_pcb());
+    schedule();
+  }
+  bench_stop();
+}
+
+/*
+ * The running process blocks, the next one wakes it up and is preempted.
+ * The arg processes have all a different priority.
+ */
+static void
+bm_block_wakeup(uint32_t n, uint32_t arg)
+{
+  uint32_t        i;
+  pcb            *p;
+
+  for (i = 0; i < arg; i++)
+    create_proc("increment", BAS_PRI + i % (MAX_PRI - BAS_PRI), 0, NULL);
+
+  schedule();
+
+  bench_start();
+  for (i = 0; i < n; i++)
+  {
+    p = get_current_pcb();
+    kblock_pcb(p, BLOCKED);
+    kwakeup_pcb(p);
+    schedule();
+  }
+  bench_stop();
+}
+
+/*
+ * arg processes go to sleep, then are all woken up
+ */
+static void
+bm_sleep_wakeup(uint32_t n, uint32_t arg)
+{
+  uint32_t        i, j, now;
+  pcb            *p;
+
+  bench_spawn(arg, BAS_PRI);
+
+  bench_start();
+  for (i = 0; i < n; i++)
+  {
+    now = kget_count();
+
+    for (j = 0; j < arg; j++)
+    {
+      p = get_current_pcb();
+      sleep_add(p, now + (j * 7919) % arg + 1);
+      schedule();
+    }
+
+    process_sleep(now + arg + 1);
+    schedule();
+  }
+  bench_stop();
+}
+
+/*
+ * A message goes from a process to an other one, among arg processes. The
+ * two are the last ones created.
+ */
+static void
+bm_send_recv(uint32_t n, uint32_t arg)
+{
+  uint32_t        i;
+  int32_t         sdr, recv, data;
+  msg_arg         s, r;
+
+  for (i = 2; i < arg; i++)
+    create_proc("increment", BAS_PRI, 0, NULL);
+
+  sdr = create_proc("increment", BAS_PRI, 0, NULL);
+  recv = create_proc("increment", BAS_PRI, 0, NULL);
+
+  schedule();
+
+  s.datatype = INT_T;
+  s.pid = recv;
+  s.pri = MIN_MPRI;
+  s.timeout = 0;
+  s.filter = FNONE;
+
+  r.data = &data;
+  r.datatype = INT_T;
+  r.pid = sdr;
+  r.pri = MIN_MPRI;
+  r.timeout = 0;
+  r.filter = FNONE;
+
+  bench_start();
+  for (i = 0; i < n; i++)
+  {
+    s.data = (void *) i;
+    send_msg(sdr, &s);
+    recv_msg(recv, &r);
+  }
+  bench_stop();
+}
+
+/*
+ * Write a payload of MSG_BUF_SIZE - 1 chars and its '\0'
+ */
+static void
+bench_fill(char *s, uint32_t seed)
+{
+  uint32_t        i;
+
+  for (i = 0; i < MSG_BUF_SIZE - 1; i++)
+    s[i] = 'a' + (i + seed) % 26;
+  s[i] = '\0';
+}
+
+/*
+ * Read a payload up to its '\0'
+ */
+static uint32_t
+bench_sum(char *s)
+{
+  uint32_t        sum = 0;
+
+  while (*s != '\0')
+    sum += *s++;
+
+  return sum;
+}
+
+/*
+ * A message of MSG_BUF_SIZE - 1 chars, that the sender writes and the
+ * receiver reads: copied as a CHAR_PTR if arg is 0, in a buffer of the pool
+ * taken and given back by the receiver otherwise. The difference is the
+ * copy of the kernel.
+ */
+static void
+bm_send_large(uint32_t n, uint32_t arg)
+{
+  static char     str[MSG_BUF_SIZE], dest[MSG_BUF_SIZE];
+  static volatile uint32_t sum;
+  uint32_t        i;
+  int32_t         sdr, recv;
+  char           *buf;
+  msg_arg         s, r;
+
+  sdr = create_proc("increment", BAS_PRI, 0, NULL);
+  recv = create_proc("increment", BAS_PRI, 0, NULL);
+
+  schedule();
+
+  s.datatype = arg ? BUF_T : CHAR_PTR;
+  s.data = str;
+  s.pid = recv;
+  s.pri = BAS_MPRI;
+  s.timeout = 0;
+  s.filter = FNONE;
+
+  r.data = arg ? (void *) &buf : (void *) dest;
+  r.datatype = s.datatype;
+  r.pid = sdr;
+  r.pri = MIN_MPRI;
+  r.timeout = 0;
+  r.filter = FTYPE;
+
+  bench_start();
+  for (i = 0; i < n; i++)
+  {
+    if (arg)
+      s.data = kbuf_alloc(sdr);
+
+    bench_fill(s.data, i);
+    send_msg(sdr, &s);
+    recv_msg(recv, &r);
+
+    if (arg)
+    {
+      sum += bench_sum(buf);
+      kbuf_free(recv, buf);
+    }
+    else
+      sum += bench_sum(dest);
+  }
+  bench_stop();
+}
+
+/*
+ * A receive filtered by sender, in a mailbox with MAX_MSG - 1 messages of
+ * the arg - 1 other senders ahead
+ */
+static void
+bm_recv_mixed(uint32_t n, uint32_t arg)
+{
+  uint32_t        i;
+  int32_t         recv, data, sdr[MAX_MSG];
+  msg_arg         s, r;
+
+  recv = create_proc("increment", BAS_PRI, 0, NULL);
+
+  for (i = 0; i < arg; i++)
+    sdr[i] = create_proc("increment", BAS_PRI, 0, NULL);
+
+  s.datatype = INT_T;
+  s.pid = recv;
+  s.pri = MIN_MPRI;
+  s.timeout = 0;
+  s.filter = FNONE;
+
+  for (i = 0; i < MAX_MSG - 1; i++)
+  {
+    s.data = (void *) i;
+    send_msg(sdr[i % (arg - 1)], &s);
+  }
+
+  r.data = &data;
+  r.datatype = INT_T;
+  r.pid = sdr[arg - 1];
+  r.pri = MIN_MPRI;
+  r.timeout = 0;
+  r.filter = FPID;
+
+  bench_start();
+  for (i = 0; i < n; i++)
+  {
+    s.data = (void *) i;
+    send_msg(sdr[arg - 1], &s);
+    recv_msg(recv, &r);
+  }
+  bench_stop();
+}
+
+/*
+ * Give the cpu until the process pid runs. With the stride scheduler, the
+ * processes of lower priority run too.
+ */
+static void
+bench_switch_to(int32_t pid)
+{
+  while (pcb_get_pid(get_current_pcb()) != pid)
+  {
+    sched_expire(get_current_pcb());
+    schedule();
+  }
+}
+
+/*
+ * The receiver waits for a message before it is sent, like in ring: it
+ * traps, blocks, the sender sends and gives the cpu back. The receiver
+ * traps again while its RECV did not give the message. The two have a
+ * higher priority than the arg - 2 others.
+ */
+static void
+bm_recv_block(uint32_t n, uint32_t arg)
+{
+  uint32_t        i;
+  int32_t         sdr, recv, data;
+  msg_arg         s, r;
+
+  for (i = 2; i < arg; i++)
+    create_proc("increment", BAS_PRI, 0, NULL);
+
+  recv = create_proc("increment", BAS_PRI + 1, 0, NULL);
+  sdr = create_proc("increment", BAS_PRI + 1, 0, NULL);
+
+  schedule();
+  bench_switch_to(recv);
+
+  s.datatype = INT_T;
+  s.pid = recv;
+  s.pri = MIN_MPRI;
+  s.timeout = 0;
+  s.filter = FNONE;
+
+  r.data = &data;
+  r.datatype = INT_T;
+  r.pid = sdr;
+  r.pri = MIN_MPRI;
+  r.timeout = 5000;
+  r.filter = FPID;
+
+  bench_start();
+  for (i = 0; i < n; i++)
+  {
+    syscall_one((int32_t) & r, RECV);
+    bench_switch_to(sdr);
+
+    s.data = (void *) i;
+    syscall_one((int32_t) & s, SEND);
+    bench_switch_to(recv);
+
+    if (get_current_pcb()->registers.v_reg[0] != sdr)
+      syscall_one((int32_t) & r, RECV);
+  }
+  bench_stop();
+}
+
+/*
+ * A request and its reply with messages, like the philosophers and their
+ * waiter: the client sends and waits in RECV, the server wakes up, sends
+ * the reply and waits in RECV for the next request. Two sends, two
+ * receives and two passes in the scheduler. The two have a higher priority
+ * than the arg - 2 others.
+ */
+static void
+bm_rpc_msg(uint32_t n, uint32_t arg)
+{
+  uint32_t        i;
+  int32_t         server, client, req, rep;
+  msg_arg         sc, rc, ss, rs;
+
+  for (i = 2; i < arg; i++)
+    create_proc("increment", BAS_PRI, 0, NULL);
+
+  server = create_proc("increment", BAS_PRI + 1, 0, NULL);
+  client = create_proc("increment", BAS_PRI + 1, 0, NULL);
+
+  schedule();
+  bench_switch_to(server);
+
+  sc.datatype = ss.datatype = rc.datatype = rs.datatype = INT_T;
+  sc.pri = ss.pri = rc.pri = rs.pri = BAS_MPRI;
+  sc.timeout = ss.timeout = rc.timeout = rs.timeout = 0;
+  sc.filter = ss.filter = FNONE;
+  rc.filter = rs.filter = FTYPE;
+
+  sc.pid = server;
+  ss.pid = client;
+  rc.data = &rep;
+  rs.data = &req;
+
+  syscall_one((int32_t) & rs, RECV);
+  bench_switch_to(client);
+
+  bench_start();
+  for (i = 0; i < n; i++)
+  {
+    sc.data = (void *) i;
+    syscall_one((int32_t) & sc, SEND);
+    syscall_one((int32_t) & rc, RECV);
+    bench_switch_to(server);
+
+    ss.data = (void *) req;
+    syscall_one((int32_t) & ss, SEND);
+    syscall_one((int32_t) & rs, RECV);
+    bench_switch_to(client);
+  }
+  bench_stop();
+}
+
+/*
+ * The same round trip with CALL and REPLYWAIT: the cpu goes straight from
+ * the client to the server and back
+ */
+static void
+bm_rpc_call(uint32_t n, uint32_t arg)
+{
+  uint32_t        i;
+  int32_t         server, client, req, rep;
+
+  for (i = 2; i < arg; i++)
+    create_proc("increment", BAS_PRI, 0, NULL);
+
+  server = create_proc("increment", BAS_PRI + 1, 0, NULL);
+  client = create_proc("increment", BAS_PRI + 1, 0, NULL);
+
+  schedule();
+  bench_switch_to(server);
+
+  syscall_three(-1, 0, (int32_t) & req, REPLYWAIT);
+  bench_switch_to(client);
+
+  bench_start();
+  for (i = 0; i < n; i++)
+  {
+    syscall_three(server, i, (int32_t) & rep, CALL);
+    bench_switch_to(server);
+
+    syscall_three(client, req, (int32_t) & req, REPLYWAIT);
+    bench_switch_to(client);
+  }
+  bench_stop();
+}
+
+/*
+ * A process is created, killed and waited for, among arg processes. It has
+ * its own priority, so that only the allocation depends on arg.
+ */
+static void
+bm_create_exit(uint32_t n, uint32_t arg)
+{
+  uint32_t        i;
+  int32_t         pid, status;
+
+  bench_spawn(arg, BAS_PRI);
+
+  bench_start();
+  for (i = 0; i < n; i++)
+  {
+    pid = create_proc("increment", BAS_PRI + 1, 0, NULL);
+    kkill(pid);
+    waitfor(pid, &status);
+  }
+  bench_stop();
+}
+
+/*
+ * Like create_exit, with 4 arguments in arrays of ARG_SIZE chars (arg = 0)
+ * or in a block (arg = 1)
+ */
+static void
+bm_create_args(uint32_t n, uint32_t arg)
+{
+  uint32_t        i;
+  int32_t         pid, status;
+  char            params[4][ARG_SIZE];
+  argblock        args;
+
+  strcpy("increment", params[0]);
+  strcpy("12", params[1]);
+  strcpy("1", params[2]);
+  strcpy("23", params[3]);
+
+  args_init(&args, "increment");
+  args_add(&args, "12");
+  args_add(&args, "1");
+  args_add(&args, "23");
+
+  bench_spawn(1, BAS_PRI);
+
+  bench_start();
+  for (i = 0; i < n; i++)
+  {
+    if (arg == 0)
+      pid = create_proc("increment", BAS_PRI + 1, 3, (char **) params);
+    else
+      pid = create_proc_args(BAS_PRI + 1, &args);
+
+    kkill(pid);
+    waitfor(pid, &status);
+  }
+  bench_stop();
+}
+
+/*
+ * arg processes are created with a syscall each (many = 0) or with a single
+ * one (many = 1). They are killed out of the timed part.
+ */
+static void
+bench_spawn_args(uint32_t n, uint32_t arg, bool many)
+{
+  static int      pids[MAXPCB];
+  uint32_t        i, j;
+  int32_t         status;
+  argblock        args;
+
+  args_init(&args, "increment");
+  args_add(&args, "12");
+
+  bench_spawn(1, BAS_PRI);
+
+  for (i = 0; i < n; i++)
+  {
+    bench_start();
+    if (many)
+      fourchette_many("increment", BAS_PRI + 1, arg, &args, 1, pids);
+    else
+      for (j = 0; j < arg; j++)
+        pids[j] = fourchette_args(&args, BAS_PRI + 1);
+    bench_stop();
+
+    for (j = 0; j < arg; j++)
+    {
+      kkill(pids[j]);
+      waitfor(pids[j], &status);
+    }
+  }
+}
+
+static void
+bm_spawn_loop(uint32_t n, uint32_t arg)
+{
+  bench_spawn_args(n, arg, FALSE);
+}
+
+static void
+bm_spawn_many(uint32_t n, uint32_t arg)
+{
+  bench_spawn_args(n, arg, TRUE);
+}
+
+/*
+ * A syscall, through syscall_handler
+ */
+static void
+bm_syscall(uint32_t n, uint32_t arg)
+{
+  uint32_t        i;
+
+  bench_spawn(1, BAS_PRI);
+
+  bench_start();
+  for (i = 0; i < n; i++)
+    syscall_none(GETPID);
+  bench_stop();
+}
+
+/*
+ * The information of arg processes, one syscall per process like ps did
+ */
+static void
+bm_ps_pinfo(uint32_t n, uint32_t arg)
+{
+  static int32_t  pids[MAXPCB];
+  uint32_t        i, j, len;
+  pcbinfo         pi;
+
+  bench_spawn(arg, BAS_PRI);
+
+  bench_start();
+  for (i = 0; i < n; i++)
+  {
+    len = syscall_one((int32_t) pids, GETALLPID);
+
+    for (j = 0; j < len; j++)
+      syscall_two(pids[j], (int32_t) & pi, GETPINFO);
+  }
+  bench_stop();
+}
+
+/*
+ * The information of arg processes, with one syscall
+ */
+static void
+bm_ps_snapshot(uint32_t n, uint32_t arg)
+{
+  static psinfo   tab[MAXPCB];
+  uint32_t        i;
+
+  bench_spawn(arg, BAS_PRI);
+
+  bench_start();
+  for (i = 0; i < n; i++)
+    syscall_two((int32_t) tab, MAXPCB, GETPSINFO);
+  bench_stop();
+}
+
+/*
+ * All the benchmarks
+ */
+static bench benches[] = {
+  {"schedule_rr/2", bm_schedule_rr, 2},
+  {"schedule_rr/10", bm_schedule_rr, 10},
+  {"schedule_rr/max", bm_schedule_rr, MAXPCB - 1},
+  {"block_wakeup/2", bm_block_wakeup, 2},
+  {"block_wakeup/10", bm_block_wakeup, 10},
+  {"block_wakeup/max", bm_block_wakeup, MAXPCB - 1},
+  {"sleep_wakeup/1", bm_sleep_wakeup, 1},
+  {"sleep_wakeup/10", bm_sleep_wakeup, 10},
+  {"sleep_wakeup/max", bm_sleep_wakeup, MAXPCB - 1},
+  {"send_recv/2", bm_send_recv, 2},
+  {"send_recv/10", bm_send_recv, 10},
+  {"send_recv/max", bm_send_recv, MAXPCB},
+  {"send_large/str", bm_send_large, 0},
+  {"send_large/buf", bm_send_large, 1},
+  {"recv_mixed/2", bm_recv_mixed, 2},
+  {"recv_mixed/10", bm_recv_mixed, 10},
+  {"recv_block/2", bm_recv_block, 2},
+  {"recv_block/10", bm_recv_block, 10},
+  {"rpc_msg/2", bm_rpc_msg, 2},
+  {"rpc_msg/10", bm_rpc_msg, 10},
+  {"rpc_call/2", bm_rpc_call, 2},
+  {"rpc_call/10", bm_rpc_call, 10},
+  {"create_exit/1", bm_create_exit, 1},
+  {"create_exit/10", bm_create_exit, 10},
+  {"create_exit/max", bm_create_exit, MAXPCB - 1},
+  {"create_args/slots", bm_create_args, 0},
+  {"create_args/block", bm_create_args, 1},
+  {"spawn_loop/10", bm_spawn_loop, 10},
+  {"spawn_many/10", bm_spawn_many, 10},
+#if MAXPCB > 100
+  {"spawn_loop/100", bm_spawn_loop, 100},
+  {"spawn_many/100", bm_spawn_many, 100},
+#endif
+  {"syscall_getpid", bm_syscall, 0},
+  {"ps_pinfo/10", bm_ps_pinfo, 10},
+  {"ps_pinfo/max", bm_ps_pinfo, MAXPCB},
+  {"ps_snapshot/10", bm_ps_snapshot, 10},
+  {"ps_snapshot/max", bm_ps_snapshot, MAXPCB},
+  {NULL, NULL, 0}
+};
+
+/*
+ * Print s in a column of width w
+ */
+static void
+bench_column(char *s, uint32_t w, bool right)
+{
+  uint32_t        l = strlen(s);
+
+  if (!right)
+    hal_print(s);
+
+  for (; l < w; l++)
+    hal_putc(' ');
+
+  if (right)
+    hal_print(s);
+}
+
+/*
+ * Run a benchmark and print its result
+ */
+static void
+bench_run(bench * b)
+{
+  uint32_t        n = 1;
+  char            s[12];
+
+  do
+  {
+    bench_boot();
+    bench_time = 0;
+    b->fn(n, b->arg);
+
+    if (bench_time >= BENCH_MIN_TIME || n >= BENCH_MAX_ITER)
+      break;
+
+    n *= 10;
+  }
+  while (1);
+
+  bench_column(b->name, 24, FALSE);
+  bench_column(itos(bench_time / n, s), 12, TRUE);
+  bench_column(itos(n, s), 12, TRUE);
+  hal_putc('\n');
+}
+
+/**
+ * \private
+ * Run all the benchmarks
+ */
+int
+main()
+{
+  bench          *b;
+
+  bench_column("Benchmark", 24, FALSE);
+  bench_column("ns/op", 12, TRUE);
+  bench_column("Iterations", 12, TRUE);
+  hal_putc('\n');
+
+  for (b = benches; b->name != NULL; b++)
+    bench_run(b);
+
+  return 0;
+}
+
+/* end of file bench.c */
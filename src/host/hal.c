@@ -0,0 +1,260 @@
+/**
+ * @file hal.c
+ * @brief Hardware abstraction layer of the host build
+ */
+
+#include <types.h>
+#include <registers.h>
+#include "../kernel/asm.h"
+#include "../kernel/kprocess.h"
+#include "../kernel/ksyscall.h"
+#include "hal.h"
+
+/*
+ * Linux i386 syscalls
+ */
+#define SYS_EXIT 1
+#define SYS_WRITE 4
+#define SYS_CLOCK_GETTIME 265
+#define CLOCK_MONOTONIC 1
+
+/*
+ * Devices
+ */
+ds12887_t       hal_rtc;
+ns16550_t       hal_tty = {.lsr.reg = 0x60 };   /* thre and temt: always ready */
+display_t       hal_malta;
+
+/*
+ * cp0 and exception registers
+ */
+static uint32_t hal_sr;
+static uint32_t hal_cause;
+static uint32_t hal_compare;
+static uint32_t hal_count_base;
+static registers_t *hal_regs;
+
+/*
+ * Registers used by the syscalls done without current process
+ */
+static registers_t hal_kregs;
+
+/*
+ * Do a Linux syscall
+ */
+static int32_t
+hal_linux(int32_t n, int32_t a, int32_t b, int32_t c)
+{
+  int32_t         r;
+
+  __asm__ volatile ("int $0x80":"=a" (r):"a"(n), "b"(a), "c"(b), "d"(c)
+                    :"memory");
+
+  return r;
+}
+
+/*
+ * Entry point
+ */
+void
+_start()
+{
+  hal_exit(main());
+}
+
+/**
+ * \private
+ * Write a char on the standard output
+ */
+void
+hal_putc(char c)
+{
+  hal_linux(SYS_WRITE, 1, (int32_t) & c, 1);
+}
+
+/**
+ * \private
+ * Write a string on the standard output
+ */
+void
+hal_print(char *s)
+{
+  int32_t         n = 0;
+
+  while (s[n] != '\0')
+    n++;
+
+  hal_linux(SYS_WRITE, 1, (int32_t) s, n);
+}
+
+/*
+ * Read the host monotonic clock
+ */
+static void
+hal_clock(int32_t * sec, int32_t * nsec)
+{
+  int32_t         ts[2];
+
+  hal_linux(SYS_CLOCK_GETTIME, CLOCK_MONOTONIC, (int32_t) ts, 0);
+
+  *sec = ts[0];
+  *nsec = ts[1];
+}
+
+/**
+ * \private
+ * Return the time of the host monotonic clock
+ */
+uint32_t
+hal_now_ns()
+{
+  int32_t         sec, nsec;
+
+  hal_clock(&sec, &nsec);
+
+  return (uint32_t) sec * 1000000000 + nsec;
+}
+
+/**
+ * \private
+ * Leave the program
+ */
+void
+hal_exit(int32_t code)
+{
+  hal_linux(SYS_EXIT, code, 0, 0);
+
+  while (1);
+}
+
+/*
+ * asm.S
+ */
+
+uint32_t
+kset_sr(uint32_t and_mask, uint32_t or_mask)
+{
+  hal_sr = (hal_sr & and_mask) | or_mask;
+
+  return hal_sr;
+}
+
+uint32_t
+kget_sr()
+{
+  return hal_sr;
+}
+
+uint32_t
+kset_cause(uint32_t and_mask, uint32_t or_mask)
+{
+  hal_cause = (hal_cause & and_mask) | or_mask;
+
+  return hal_cause;
+}
+
+uint32_t
+kget_cause()
+{
+  return hal_cause;
+}
+
+/*
+ * count runs at timer_usec counts per us, like on the Malta, and wraps the
+ * same way
+ */
+uint32_t
+kget_count()
+{
+  int32_t         sec, nsec;
+
+  hal_clock(&sec, &nsec);
+
+  return ((uint32_t) sec * 1000000 + nsec / 1000) * timer_usec
+    - hal_count_base;
+}
+
+void
+kload_timer(uint32_t timer_value)
+{
+  hal_count_base += kget_count();
+  hal_compare = timer_value;
+}
+
+void
+kset_compare(uint32_t count_value)
+{
+  hal_compare = count_value;
+}
+
+void
+kset_registers(registers_t * regs)
+{
+  hal_regs = regs;
+}
+
+registers_t    *
+kget_registers()
+{
+  return hal_regs;
+}
+
+void
+kdebug_magic_break()
+{
+}
+
+void
+kidle()
+{
+  while (1);
+}
+
+/*
+ * syscall.S: there is no user mode, the handler is called directly with the
+ * registers of the current process
+ */
+
+static int32_t
+hal_syscall(int32_t a0, int32_t a1, int32_t a2, int32_t scode)
+{
+  registers_t    *regs = &hal_kregs;
+
+  if (get_current_pcb() != NULL)
+    regs = &get_current_pcb()->registers;
+
+  regs->a_reg[0] = a0;
+  regs->a_reg[1] = a1;
+  regs->a_reg[2] = a2;
+  regs->v_reg[0] = scode;
+
+  syscall_handler(regs);
+
+  return regs->v_reg[0];
+}
+
+int32_t
+syscall_none(int32_t scode)
+{
+  return hal_syscall(scode, 0, 0, scode);
+}
+
+int32_t
+syscall_one(int32_t p1, int32_t scode)
+{
+  return hal_syscall(p1, scode, 0, scode);
+}
+
+int32_t
+syscall_two(int32_t p1, int32_t p2, int32_t scode)
+{
+  return hal_syscall(p1, p2, scode, scode);
+}
+
+int32_t
+syscall_three(int32_t p1, int32_t p2, int32_t p3, int32_t scode)
+{
+  return hal_syscall(p1, p2, p3, scode);
+}
+
+/* end of file hal.c */
@@ -0,0 +1,65 @@
+/**
+ * @file hal.h
+ * @brief Hardware abstraction layer of the host build
+ *
+ * With HOST defined, the kernel is built for a x86 Linux host (32 bits,
+ * since the kernel keeps addresses in 32 bits registers) to run the
+ * scheduler and IPC code under perf or valgrind. This layer replaces
+ * asm.S, syscall.S and the devices of malta.h:
+ *     - the cp0 registers are plain variables, count follows the host clock
+ *       at the Malta rate (timer_usec counts per us). Reading it is a host
+ *       syscall, which weighs on the timings of the scheduler,
+ *     - the syscalls directly call syscall_handler,
+ *     - the tty only writes on the standard output.
+ * The binaries do not use the libc, the few needed Linux syscalls are done
+ * here.
+ */
+
+#ifndef __HAL_H
+#define __HAL_H
+
+#include <types.h>
+#include <ds12887.h>
+#include <ns16550.h>
+#include "../kernel/display.h"
+
+/**
+ * @brief Devices seen by the kernel in place of the Malta ones
+ */
+extern ds12887_t hal_rtc;
+extern ns16550_t hal_tty;
+extern display_t hal_malta;
+
+/**
+ * @brief Write a char on the standard output
+ * @param c the char
+ */
+void            hal_putc(char c);
+
+/**
+ * @brief Write a string on the standard output
+ * @param s the string
+ */
+void            hal_print(char *s);
+
+/**
+ * @brief Return the time of the host monotonic clock
+ * @return the time, in ns. It wraps after 4 s.
+ */
+uint32_t        hal_now_ns();
+
+/**
+ * @brief Leave the program
+ * @param code the exit code
+ */
+void            hal_exit(int32_t code);
+
+/**
+ * @brief Entry point of the host programs, called by _start
+ * @return the exit code
+ */
+int             main();
+
+#endif
+
+/* end of file hal.h */
@@ -0,0 +1,21 @@
+/**
+ * @file test_host.c
+ * @brief Run the tests of src/test on the host
+ */
+
+#include "../kernel/test.h"
+#include "hal.h"
+
+/**
+ * \private
+ * Run the tests enabled in test.c
+ */
+int
+main()
+{
+  test();
+
+  return 0;
+}
+
+/* end of file test_host.c */
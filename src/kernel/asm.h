@@ -20,9 +20,12 @@ uint32_t        kget_sr();
 uint32_t        kset_cause(uint32_t and_mask, uint32_t or_mask);
 uint32_t        kget_cause();
 void            kload_timer(uint32_t timer_value);
+uint32_t        kget_count();
+void            kset_compare(uint32_t count_value);
 void            kset_registers(registers_t * regs);
 registers_t    *kget_registers();
 void            kdebug_magic_break();
+void            kidle();
 
 /*
  * kexception is called when an exception occurs, after registers
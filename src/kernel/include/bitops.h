@@ -0,0 +1,27 @@
+/**
+ * @file bitops.h
+ * @brief Bit scanning helpers for the kernel bitmaps
+ */
+
+#ifndef BITOPS_H
+#define BITOPS_H
+
+#include "types.h"
+
+/**
+ * @brief Index of the most significant bit set in a word.
+ *
+ * Compiled to a single clz instruction on mips32. The word must not be 0.
+ */
+#define fls32(x) (31 - __builtin_clz(x))
+
+/**
+ * @brief Index of the least significant bit set in a word.
+ *
+ * The word must not be 0.
+ */
+#define ffs32(x) (__builtin_ctz(x))
+
+#endif
+
+/* end of file bitops.h */
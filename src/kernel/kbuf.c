@@ -0,0 +1,174 @@
+/**
+ * \file kbuf.c
+ * \brief Pool of the message buffers
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include "kbuf.h"
+
+/**
+ * @brief End of the list of free buffers
+ */
+#define NIL -1
+
+/**
+ * @brief The buffers, in words so that they are aligned
+ */
+static uint32_t buf_pool[MSG_BUFS][KBUF_WORDS];
+
+/**
+ * @brief pid of the owner of each buffer, KBUF_FREE if it is free
+ */
+static int32_t  buf_owner[MSG_BUFS];
+
+/**
+ * @brief List of the free buffers, linked by buffer number
+ */
+static int32_t  free_head;
+static int32_t  free_next[MSG_BUFS];
+
+/**
+ * @brief Number of free buffers
+ */
+static uint32_t free_count;
+
+/*
+ * Number of the buffer at the address buf, NIL if it is not the beginning
+ * of a buffer
+ */
+static int32_t
+kbuf_index(void *buf)
+{
+  uint32_t        off = (uint32_t) buf - (uint32_t) buf_pool;
+
+  if ((uint32_t) buf < (uint32_t) buf_pool || off >= sizeof(buf_pool)
+      || off % sizeof(buf_pool[0]) != 0)
+    return NIL;
+
+  return off / sizeof(buf_pool[0]);
+}
+
+/*
+ * Put the buffer i back in the free list
+ */
+static void
+kbuf_push(int32_t i)
+{
+  buf_owner[i] = KBUF_FREE;
+  free_next[i] = free_head;
+  free_head = i;
+  free_count++;
+}
+
+/**
+ * \private
+ * Make all the buffers free, the first ones are given first
+ */
+void
+kbuf_reset()
+{
+  int32_t         i;
+
+  free_head = NIL;
+  free_count = 0;
+
+  for (i = MSG_BUFS - 1; i >= 0; i--)
+    kbuf_push(i);
+}
+
+/**
+ * \private
+ * Take a buffer from the pool
+ */
+void           *
+kbuf_alloc(uint32_t pid)
+{
+  int32_t         i = free_head;
+
+  if (i == NIL)
+    return NULL;
+
+  free_head = free_next[i];
+  free_count--;
+  buf_owner[i] = pid;
+
+  return buf_pool[i];
+}
+
+/**
+ * \private
+ * Give a buffer back to the pool
+ */
+int32_t
+kbuf_free(uint32_t pid, void *buf)
+{
+  int32_t         i = kbuf_index(buf);
+
+  if (i == NIL || buf_owner[i] == KBUF_FREE || buf_owner[i] != pid)
+    return INVARG;
+
+  kbuf_push(i);
+
+  return OMGROXX;
+}
+
+/**
+ * \private
+ * Owner of a buffer
+ */
+int32_t
+kbuf_owner(void *buf)
+{
+  int32_t         i = kbuf_index(buf);
+
+  if (i == NIL)
+    return KBUF_FREE;
+
+  return buf_owner[i];
+}
+
+/**
+ * \private
+ * Give a buffer to an other process
+ */
+void
+kbuf_give(void *buf, uint32_t pid)
+{
+  int32_t         i = kbuf_index(buf);
+
+  if (i != NIL && buf_owner[i] != KBUF_FREE)
+    buf_owner[i] = pid;
+}
+
+/**
+ * \private
+ * Give back to the pool all the buffers of a process
+ */
+uint32_t
+kbuf_release(uint32_t pid)
+{
+  int32_t         i;
+  uint32_t        n = 0;
+
+  for (i = 0; i < MSG_BUFS; i++)
+    if (buf_owner[i] != KBUF_FREE && buf_owner[i] == pid)
+    {
+      kbuf_push(i);
+      n++;
+    }
+
+  return n;
+}
+
+/**
+ * \private
+ * Number of free buffers in the pool
+ */
+uint32_t
+kbuf_free_count()
+{
+  return free_count;
+}
+
+/* end of file kbuf.c */
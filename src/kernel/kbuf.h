@@ -0,0 +1,79 @@
+/**
+ * \file kbuf.h
+ * \brief Pool of the message buffers
+ *
+ * A process takes a buffer of MSG_BUF_SIZE bytes from the pool, fills it
+ * and sends it as a message of type BUF_T. The buffer is not copied: the
+ * receiver becomes its owner and gets its address, and gives it back to
+ * the pool when it is done. The buffers of a process that terminates,
+ * including the ones still in its mailbox, go back to the pool.
+ */
+
+#ifndef __KBUF_H
+#define __KBUF_H
+
+#include <types.h>
+#include <message.h>
+
+/**
+ * @brief Size of a buffer in words: MSG_BUF_SIZE bytes rounded up, so that
+ * a buffer is never shorter than MSG_BUF_SIZE and the next one is aligned
+ */
+#define KBUF_WORDS ((MSG_BUF_SIZE + sizeof(uint32_t) - 1) / sizeof(uint32_t))
+
+/**
+ * @brief Owner of a free buffer
+ */
+#define KBUF_FREE -1
+
+/**
+ * @brief Make all the buffers free
+ */
+void            kbuf_reset();
+
+/**
+ * @brief Take a buffer from the pool
+ * @param pid the pid of the new owner
+ * @return the address of the buffer, NULL if there is no free buffer
+ */
+void           *kbuf_alloc(uint32_t pid);
+
+/**
+ * @brief Give a buffer back to the pool
+ * @param pid the pid of the process giving it back
+ * @param buf the address of the buffer
+ * @return OMGROXX, or INVARG if it is not a buffer owned by pid
+ */
+int32_t         kbuf_free(uint32_t pid, void *buf);
+
+/**
+ * @brief Owner of a buffer
+ * @param buf the address of the buffer
+ * @return the pid of the owner, KBUF_FREE if the buffer is free or if buf
+ * is not a buffer of the pool
+ */
+int32_t         kbuf_owner(void *buf);
+
+/**
+ * @brief Give a buffer to an other process
+ * @param buf the address of the buffer, owned by a process
+ * @param pid the pid of the new owner
+ */
+void            kbuf_give(void *buf, uint32_t pid);
+
+/**
+ * @brief Give back to the pool all the buffers of a process
+ * @param pid the pid of the process
+ * @return the number of buffers given back
+ */
+uint32_t        kbuf_release(uint32_t pid);
+
+/**
+ * @brief Number of free buffers in the pool
+ * @return the number of free buffers
+ */
+uint32_t        kbuf_free_count();
+
+#endif
+
+/* end of file kbuf.h */
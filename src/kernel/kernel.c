@@ -20,6 +20,8 @@
 #include "kscheduler.h"
 #include "kprogram.h"
 #include "ksleep.h"
+#include "ktimer.h"
+#include "kstat.h"
 
 static registers_t regs;
 
@@ -65,13 +67,15 @@ kinit()
   kmaltaprint8("  SSIK  ");
 
   /*
-   * Init the four list of pcb
+   * Init the run queue and the four list of pcb
    */
-  pls_reset(&plsready);
+  rq_reset(&rqready);
   pls_reset(&plsrunning);
   pls_reset(&plswaiting);
+  pls_reset(&plssleeping);
   pls_reset(&plsterminate);
 
+  kstat_reset();
   reset_next_pid();
   reset_used_stack();
   init_mem();
@@ -91,11 +95,15 @@ kinit()
   /*
    * set the exeption timer
    */
-  kload_timer(QUANTUM);
+  ktimer_init();
 
   uart_init();
-  /* Forever do nothing. */
-  while (1);
+
+  /*
+   * Forever do nothing, the exceptions return here when no process is
+   * ready
+   */
+  kidle();
 }
 
 /**
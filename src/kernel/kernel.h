@@ -11,11 +11,33 @@
 #include <types.h>
 #include <stdio.h>
 
+/*
+ * Scheduling policies, the one used is chosen at build time with
+ * make KCONFIG=-DSCHED_POLICY=SCHED_MLFQ. Defined before the includes: the
+ * run queue depends on it.
+ */
+#define SCHED_PRIO 0            /* Strict priority, Round Robin inside a priority */
+#define SCHED_MLFQ 1            /* Multi-level feedback queue */
+#define SCHED_STRIDE 2          /* Stride scheduling, cpu shared in proportion of the priorities */
+
+#ifndef SCHED_POLICY
+#define SCHED_POLICY SCHED_PRIO
+#endif
+
 #include "asm.h"
 #include "kprocess_list.h"
+#include "krunqueue.h"
 
 /* Time of one clock tick */
-#define QUANTUM 100*timer_msec
+#define QUANTUM (100*timer_msec)
+
+/*
+ * Tickless timer: the timer only interrupts for the next deadline (1) or
+ * every QUANTUM (0). Can be set with make KCONFIG=-DTICKLESS=0
+ */
+#ifndef TICKLESS
+#define TICKLESS 1
+#endif
 
 /*
  * global variable
@@ -25,9 +47,10 @@
  * declarationo of the pcb lists
  */
 
-pls             plsready;       /*!< @brief List of ready process */
-pls             plsrunning;     /*!< @brief List of running process */
+runqueue        rqready;        /*!< @brief Run queue of ready process */
+pls             plsrunning;     /*!< @brief List of the running process */
 pls             plswaiting;     /*!< @brief List of waiting process */
+pls             plssleeping;    /*!< @brief List of sleeping process, sorted by wake up date */
 pls             plsterminate;   /*!< @brief List of terminate process */
 
 
@@ -12,7 +12,7 @@
 #include "kinout.h"
 #include "kernel.h"
 
-char            err_msgs[13][255] = {
+char            err_msgs[14][255] = {
   "No error occured",
   "General error",
   "Invalid ID",
@@ -25,7 +25,8 @@ char            err_msgs[13][255] = {
   "Unknown pid (process identifier)",
   "Out of memory",
   "These are not the droid you are looking for",
-  "Process has been killed"
+  "Process has been killed",
+  "Stack overflow"
 };
 
  /**
@@ -15,7 +15,7 @@
 #include "kscheduler.h"
 #include "ksyscall.h"
 #include "kscheduler.h"
-#include "ksleep.h"
+#include "ktimer.h"
 #include "uart.h"
 #include "kprogram.h"
 
@@ -44,17 +44,22 @@ kexception()
       //kdebug_println("Exception in");
       uart_exception();    /** TODO: add uart_exception to uart file */
       kset_cause(~0x1000, 0);   // Acknowledge UART interrupt.
+
+      /*
+       * The reader of the uart may be woken up: it runs now
+       */
+      sched_check_preempt();
       //kdebug_println("Exception out");
     }
     else if (cause.field.ip & 0x80)     // timer exception
     {
-      // check if there are some processes to wake up and reschedule all processes.
-      process_sleep();
-      schedule();
-      /* Reload timer for another QUANTUM ms (simulated time) */
-      kload_timer(QUANTUM);
-      kset_cause(~0x8000, 0);   //clear the flag for timer interrupt
+      // check if there are some processes to wake up and reschedule if needed.
+      ktimer_interrupt();
     }
   }
+
+  /* Program the timer for the next thing to do */
+  ktimer_program();
+
   //kdebug_println("Exception out");
 }
@@ -47,6 +47,11 @@ kmaltaprint8(const char *str)
 void
 kprint_char(char c)
 {
+#ifdef HOST
+  hal_putc(c);                  /* the host tty is the standard output */
+  return;
+#endif
+
   while (!tty->lsr.field.thre); /* poll untill we can print */
   if (c == '\n')
   {
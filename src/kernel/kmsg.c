@@ -12,41 +12,174 @@
 #include "kprocess.h"
 #include "kprocess_list.h"
 #include "kinout.h"
+#include "kernel.h"
+#include "kscheduler.h"
+#include "ksleep.h"
+#include "ktimer.h"
+#include "asm.h"
+#include "bitops.h"
+#include "kbuf.h"
+
+/*
+ * Bucket of the index by sender of a message
+ */
+#define MSG_BUCKET(pid, type) (((pid) * MSG_TYPES + (type)) & (MSG_BUCKETS - 1))
 
 /**
- * reset the fifo buffer to default value
+ * reset the list to default value: all the slots are free
  * \private
  */
 void
 reset_mls(mls * m)
 {
-  m->in = 0;
-  m->out = 0;
+  int32_t         i, j;
+
+  m->all.first = m->all.last = MSG_NIL;
+
+  for (i = 0; i < MSG_TYPES; i++)
+  {
+    m->pmap[i] = 0;
+
+    for (j = 0; j < MSG_PRIS; j++)
+      m->bypri[i][j].first = m->bypri[i][j].last = MSG_NIL;
+  }
+
+  for (i = 0; i < MSG_BUCKETS; i++)
+    m->bysdr[i].first = m->bysdr[i].last = MSG_NIL;
+
+  for (i = 0; i < MAX_MSG; i++)
+    m->ls[i].next[MBY_ALL] = i + 1 < MAX_MSG ? i + 1 : MSG_NIL;
+
+  m->free = 0;
   m->length = 0;
   m->status = NO_WAIT;
+  m->arg = NULL;
+}
+
+/*
+ * The list of the index k that holds the message
+ */
+static mlist   *
+mls_list(mls * m, msg * mess, int32_t k)
+{
+  switch (k)
+  {
+  case MBY_PRI:
+    return &m->bypri[mess->datatype][mess->pri - MIN_MPRI];
+  case MBY_SDR:
+    return &m->bysdr[MSG_BUCKET(mess->sdr_pid, mess->datatype)];
+  default:
+    return &m->all;
+  }
+}
+
+/*
+ * Insert the slot i after the slot prev in the list l of the index k,
+ * prev = MSG_NIL to insert it first
+ */
+static void
+mls_link(mls * m, mlist * l, int32_t k, int8_t i, int8_t prev)
+{
+  int8_t          next = prev == MSG_NIL ? l->first : m->ls[prev].next[k];
+
+  m->ls[i].next[k] = next;
+  m->ls[i].prev[k] = prev;
+
+  if (prev == MSG_NIL)
+    l->first = i;
+  else
+    m->ls[prev].next[k] = i;
+
+  if (next == MSG_NIL)
+    l->last = i;
+  else
+    m->ls[next].prev[k] = i;
+}
+
+/*
+ * Remove the slot i from the list l of the index k
+ */
+static void
+mls_unlink(mls * m, mlist * l, int32_t k, int8_t i)
+{
+  mslot          *s = &m->ls[i];
+
+  if (s->prev[k] == MSG_NIL)
+    l->first = s->next[k];
+  else
+    m->ls[s->prev[k]].next[k] = s->next[k];
+
+  if (s->next[k] == MSG_NIL)
+    l->last = s->prev[k];
+  else
+    m->ls[s->next[k]].prev[k] = s->prev[k];
+}
+
+/*
+ * Copy the message of the slot i and free the slot
+ */
+static void
+mls_take(mls * m, int8_t i, msg * mess)
+{
+  mlist          *l;
+  int32_t         k;
+
+  copy_msg(&m->ls[i].m, mess);
+
+  for (k = 0; k < MSG_INDEXES; k++)
+    mls_unlink(m, mls_list(m, &m->ls[i].m, k), k, i);
+
+  l = mls_list(m, &m->ls[i].m, MBY_PRI);
+  if (l->first == MSG_NIL)
+    m->pmap[m->ls[i].m.datatype] &= ~(1u << (m->ls[i].m.pri - MIN_MPRI));
+
+  m->ls[i].next[MBY_ALL] = m->free;
+  m->free = i;
+  m->length--;
 }
 
 /**
- * push a char in the fifo buffer
+ * push a message at the end of the list
  * \private
  */
 uint32_t
 push_mls(mls * m, msg * mess)
 {
-  if (m->length >= MAX_MSG)
+  int8_t          i = m->free;
+  int8_t          prev;
+  mlist          *l;
+
+  if (mess->datatype >= MSG_TYPES || mess->pri > MAX_MPRI)
+    return INVARG;
+
+  if (i == MSG_NIL)
     return OUTOMEM;
 
-  copy_msg(mess, &m->ls[m->in++]);
-  m->length++;
+  m->free = m->ls[i].next[MBY_ALL];
+  copy_msg(mess, &m->ls[i].m);
+
+  mls_link(m, &m->all, MBY_ALL, i, m->all.last);
+
+  l = mls_list(m, mess, MBY_PRI);
+  mls_link(m, l, MBY_PRI, i, l->last);
+  m->pmap[mess->datatype] |= 1u << (mess->pri - MIN_MPRI);
 
-  if (m->in >= MAX_MSG)
-    m->in = 0;
+  /*
+   * After the last one of the bucket with a priority at least as high
+   */
+  l = mls_list(m, mess, MBY_SDR);
+  for (prev = l->last; prev != MSG_NIL && m->ls[prev].m.pri < mess->pri;
+       prev = m->ls[prev].prev[MBY_SDR]);
+
+  mls_link(m, l, MBY_SDR, i, prev);
+
+  m->length++;
 
   return OMGROXX;
 }
 
 /**
- * pop a char from the fifo buffer
+ * pop the oldest message of the list
  * \private
  */
 uint32_t
@@ -58,11 +191,51 @@ pop_mls(mls * m, msg * mess)
   if (m->length == 0)
     return FAILNOOB;
 
-  copy_msg(&m->ls[m->out++], mess);
-  m->length--;
+  mls_take(m, m->all.first, mess);
+
+  return OMGROXX;
+}
 
-  if (m->out >= MAX_MSG)
-    m->out = 0;
+/**
+ * take the message that passes the filter, of highest priority then
+ * oldest: the head of its list. Only the list of a bucket of senders can
+ * hold messages of an other sender.
+ * \private
+ */
+int32_t
+take_mls(mls * m, msg_filter filter, int32_t filtervalue, msg_t datatype,
+         msg * mess)
+{
+  int8_t          i;
+
+  if (datatype >= MSG_TYPES)
+    return INVARG;
+
+  if (filter == FPRI)
+  {
+    if (filtervalue < MIN_MPRI || filtervalue > MAX_MPRI)
+      return INVARG;
+
+    i = m->bypri[datatype][filtervalue - MIN_MPRI].first;
+  }
+  else if (filter == FPID)
+  {
+    i = m->bysdr[MSG_BUCKET(filtervalue, datatype)].first;
+
+    while (i != MSG_NIL && (m->ls[i].m.sdr_pid != filtervalue
+                            || m->ls[i].m.datatype != datatype))
+      i = m->ls[i].next[MBY_SDR];
+  }
+  else if ((filter == FTYPE && filtervalue != datatype)
+           || m->pmap[datatype] == 0)
+    i = MSG_NIL;
+  else
+    i = m->bypri[datatype][fls32(m->pmap[datatype])].first;
+
+  if (i == MSG_NIL)
+    return NOTFOUND;
+
+  mls_take(m, i, mess);
 
   return OMGROXX;
 }
@@ -106,6 +279,42 @@ copy_msg(msg * src, msg * dest)
   return OMGROXX;
 }
 
+/*
+ * Value the filter of a receive compares the messages with
+ */
+static int32_t
+filter_value(msg_arg * args)
+{
+  if (args->filter == FPRI)
+    return args->pri;
+  else if (args->filter == FPID)
+    return args->pid;
+  else
+    return (int) args->datatype;
+}
+
+/*
+ * Write the data of the message where the receiver wants it
+ */
+static void
+give_msg(msg * m, msg_arg * args)
+{
+  if (args->datatype == CHAR_PTR)       // case char *
+    strcpy(m->data, args->data);
+  else if (args->datatype == INT_T)     // case int
+  {
+    int            *b = (int *) args->data;
+    *b = (int) m->data;
+  }
+  else if (args->datatype == BUF_T)     // case buffer: its address only
+    *(void **) args->data = m->data;
+/* NOT WORKING FOR NOW
+		else{										// case other (struct ...)
+			args->data = m->data;
+		}
+*/
+}
+
 /**
  * Send the msg object.
  * \private
@@ -115,151 +324,307 @@ send_msg(uint32_t sdr_pid, msg_arg * args)
 {
   pcb            *receiver;
   msg             m;
+  mls            *box;
   uint32_t        pri = args->pri;
   uint32_t        recv_pid = args->pid;
   int32_t         res;
 //  char c[10];
   if (args == NULL)
     return NULLPTR;
-  if (pri >= MAX_MPRI && pri <= MIN_MPRI)
+  if (pri < MIN_MPRI || pri > MAX_MPRI)
     return INVPRI;
   receiver = search_all_list(recv_pid);
   if (receiver == NULL)
     return UNKNPID;
+
+  /*
+   * Only the owner of a buffer sends it
+   */
+  if (args->datatype == BUF_T && kbuf_owner(args->data) != sdr_pid)
+    return INVARG;
+
   res = create_msg(&m, sdr_pid, recv_pid, pri, args->data, args->datatype);
+  box = &receiver->messages;
+
+  /*
+   * The receiver waits for this one: it gets it at once, without going
+   * through the mailbox, and comes back from its RECV with it
+   */
+  if (pcb_get_state(receiver) == WAITING_MSG
+      && search_msg_filtered(box->filter, box->filtervalue, &m,
+                             box->arg->datatype))
+  {
+    give_msg(&m, box->arg);
+
+    if (m.datatype == BUF_T)
+      kbuf_give(m.data, recv_pid);
+
+    recv_cancel(box);
+    pcb_set_v0(receiver, sdr_pid);
+    kwakeup_pcb(receiver);
+
+    return OMGROXX;
+  }
 
 /*	kprint("SENT");
 	kprint(itos((int)m.data, c));
 	kprint(";");
-*/ res = push_mls(&receiver->messages, &m);
+*/ res = push_mls(box, &m);
   if (res != OMGROXX)
     return res;
 
-
-  // Signal the recv_process that the message is arrived (if he wanted this one)
-  if ((receiver->messages.status == WAIT_MSG))
-  {
-    /*   kprint("wake for ");
-       kprint(itos(receiver->messages.filter, c));
-       kprint(" - ");
-       kprintln(itos(receiver->messages.filtervalue, c));
-       kprint(itos(sdr_pid, c));
-     */ if ((receiver->messages.filter == FTYPE
-             && receiver->messages.filtervalue == args->datatype)
-            || (receiver->messages.filter == FPRI
-                && receiver->messages.filtervalue == pri)
-            || (receiver->messages.filter == FPID
-                && receiver->messages.filtervalue == sdr_pid)
-            || (receiver->messages.filter == FNONE))
-    {
-      receiver->messages.status = NO_WAIT;
-      kwakeup_pcb(receiver);
-    }
-  }
+  /*
+   * The buffer in the mailbox is the receiver's: it goes back to the pool
+   * with the receiver's ones if it terminates before it takes it
+   */
+  if (m.datatype == BUF_T)
+    kbuf_give(m.data, recv_pid);
 
   return OMGROXX;
 }
 
-                                                                                                                /** TODO:  IMPLEMENT RECV_MSG */
 /**
- * Wait fot a message with the specified priority.
+ * Receive a message that is in the mailbox.
  * \private
  */
 int32_t
 recv_msg(uint32_t recv_pid, msg_arg * args)
 {
-  msg_filter      filter = args->filter;
-  int             filtervalue;
   pcb            *p;
   msg             m;
   int32_t         res;
-  volatile uint32_t status;
-  bool            res2;
-  char            c[10];
-
-  if (filter == FPRI)
-    filtervalue = args->pri;
-  else if (filter == FPID)
-    filtervalue = args->pid;
-  else
-    filtervalue = (int) args->datatype;
 
   p = search_all_list(recv_pid);
   if (p == NULL)
     return UNKNPID;
 
-  do
+  // look for a message according to the filter, the others stay there
+  res =
+    take_mls(&p->messages, args->filter, filter_value(args), args->datatype,
+             &m);
+
+  /* message not in the mailbox yet */
+  if (res != OMGROXX)
+    return res;
+
+  give_msg(&m, args);
+
+  return m.sdr_pid;
+}
+
+/**
+ * Receive a message, wait for it in the kernel if it is not there.
+ * \private
+ */
+int32_t
+recv_wait(uint32_t recv_pid, msg_arg * args)
+{
+  pcb            *p;
+  mls            *box;
+  uint32_t        time;
+  int32_t         res;
+
+  if (args == NULL)
+    return NULLPTR;
+
+  res = recv_msg(recv_pid, args);
+  if (res != NOTFOUND)
+    return res;
+
+  p = search_all_list(recv_pid);
+  box = &p->messages;
+
+  box->status = WAIT_MSG;
+  box->filter = args->filter;
+  box->filtervalue = filter_value(args);
+  box->timeout = args->timeout > 0 ? args->timeout : 0;
+  box->arg = args;
+
+  sched_boost(p);
+
+  /*
+   * Waiting for a given sender: lend it our priority
+   */
+  if (args->filter == FPID)
+    sched_depend(p, search_all_list(args->pid));
+
+  /*
+   * The timeout is a wake up date in plssleeping, like a sleep. The date
+   * is compared with count on their difference, avoid overflow
+   */
+  if (box->timeout > 0)
   {
-    status = pcb_get_messages(p)->status;       //p->messages.status;
+    time = box->timeout;
+
+    if (time > TIMER_MAX_DELTA / timer_msec)
+      time = TIMER_MAX_DELTA / timer_msec;
+
+    sleep_add(p, ktimer_date(time * timer_msec));
   }
-  while (status != NO_WAIT);
+  else
+    pls_move_pcb(p, &plswaiting);
+
+  pcb_set_state(p, WAITING_MSG);
+  schedule();
+
+  /*
+   * Our v0 stays NOTFOUND if the timeout ends first
+   */
+  return NOTFOUND;
+}
+
+/**
+ * The receiver got its message, or its timeout ended
+ * \private
+ */
+void
+recv_cancel(mls * box)
+{
+  box->status = NO_WAIT;
+  box->arg = NULL;
+}
+
+/**
+ * Call a server, wait for its reply.
+ * \private
+ */
+int32_t
+call_msg(uint32_t sdr_pid, uint32_t pid, int32_t req, int32_t * reply)
+{
+  pcb            *p, *server;
+
+  if (reply == NULL)
+    return NULLPTR;
+
+  p = search_all_list(sdr_pid);
+  server = search_all_list(pid);
+
+  if (server == NULL || pcb_get_state(server) == OMG_ZOMBIE)
+    return UNKNPID;
+
+  if (server == p)
+    return INVARG;
+
+  pcb_set_ipcbuf(p, reply);
+  pcb_set_ipcword(p, req);
 
-  // look for a message according to the filter.
-  do
+  sched_boost(p);
+  sched_depend(p, server);
+  pls_move_pcb(p, &plswaiting);
+
+  /*
+   * The server waits for us: it runs now, without going through the run
+   * queue
+   */
+  if (pcb_get_state(server) == WAITING_CALL)
   {
-    res = pop_mls(&p->messages, &m);
-    if (res == OMGROXX)
-      res2 = search_msg_filtered(filter, filtervalue, &m, args->datatype);
-    else
-      res2 = FALSE;
+    *pcb_get_ipcbuf(server) = req;
+    pcb_set_ipcbuf(server, NULL);
+    pcb_set_v0(server, sdr_pid);
+
+    pcb_set_state(p, WAITING_REPLY);
+    sched_handoff(server);
+  }
+  else
+  {
+    pcb_set_state(p, CALLING);
+    schedule();
   }
-  while (res2 == FALSE && p->messages.length != 0);
 
+  /*
+   * Our v0 is written by the reply
+   */
+  return FAILNOOB;
+}
+
+/**
+ * Reply to a client, take the next call.
+ * \private
+ */
+int32_t
+reply_wait(uint32_t pid, int32_t client, int32_t rep, int32_t * req)
+{
+  pcb            *p, *c = NULL, *q;
 
-  /* message not in the mailbox yet, Go to sleep ^^ */
-  if (res2 == FALSE && args->timeout > 0)
+  p = search_all_list(pid);
+
+  if (client >= 0)
   {
-    // if not found
-    p->messages.status = WAIT_MSG;
-    p->messages.filter = filter;
-    p->messages.filtervalue = filtervalue;
-    p->messages.timeout = (args->timeout >= 0) ? args->timeout : 0;
-
-    // WAIT NOW UNTIL THE MESSAGE IS IN THE MAILBOX
-    //   kprintln("GO TO SLEEP FOR A MSG");
-
-    //go_to_sleep(args->timeout);
-    return NOTFOUND;            // go to sleep
-
-    //if (pcb_get_sleep(p) <= 0)
-    //  return FAILNOOB;
-    //   kprintln("SIGNALED MSG");
-    //check apres reveil
-    do
-    {
-      res = pop_mls(&p->messages, &m);
-      if (res == OMGROXX)
-        res2 = search_msg_filtered(filter, filtervalue, &m, args->datatype);
-      else
-        res2 = FALSE;
-    }
-    while (res2 == FALSE && p->messages.length != 0);
+    c = search_all_list(client);
+
+    if (c == NULL || pcb_get_state(c) != WAITING_REPLY
+        || pcb_get_blocker(c) != p)
+      return UNKNPID;
+
+    *pcb_get_ipcbuf(c) = rep;
+    pcb_set_ipcbuf(c, NULL);
+    pcb_set_v0(c, OMGROXX);
   }
 
-  /* if the message is found (with or without waiting time) */
-  if (res2 == TRUE)
+  if (req == NULL)
   {
-    if (args->datatype == CHAR_PTR)     // case char *
-      strcpy(m.data, args->data);
-    else if (args->datatype == INT_T)   // case int
-    {
-      int            *b = (int *) args->data;
-      *b = (int) m.data;
-    }
-/* NOT WORKING FOR NOW
-		else{										// case other (struct ...)
-			args->data = m.data;
-			kprintln(itos((int)args->data, resc));
-		}
-*/
-    c[0] = '\0';
-    //kprint(itos((int)args->pid, c));
-    return m.sdr_pid;
+    kwakeup_pcb(c);
+    return OMGROXX;
   }
 
+  /*
+   * The oldest call not taken yet: the callers are in plswaiting in the
+   * order they came
+   */
+  for (q = plswaiting.start; q != NULL; q = pcb_get_next(q))
+    if (pcb_get_state(q) == CALLING && pcb_get_blocker(q) == p)
+      break;
+
+  if (q != NULL)
+  {
+    *req = pcb_get_ipcword(q);
+    pcb_set_state(q, WAITING_REPLY);
+    kwakeup_pcb(c);
+
+    return pcb_get_pid(q);
+  }
+
+  pcb_set_ipcbuf(p, req);
+  sched_boost(p);
+  pls_move_pcb(p, &plswaiting);
+  pcb_set_state(p, WAITING_CALL);
+
+  /*
+   * Back to the client at once, the caller to come writes our v0
+   */
+  if (c != NULL)
+    sched_handoff(c);
+  else
+    schedule();
+
   return FAILNOOB;
 }
 
+/**
+ * A server terminates, its clients wake up.
+ * \private
+ */
+void
+call_orphan(uint32_t pid)
+{
+  pcb            *server, *q, *next;
+
+  server = search_all_list(pid);
+
+  for (q = plswaiting.start; q != NULL; q = next)
+  {
+    next = pcb_get_next(q);
+
+    if ((pcb_get_state(q) == CALLING || pcb_get_state(q) == WAITING_REPLY)
+        && pcb_get_blocker(q) == server)
+    {
+      pcb_set_ipcbuf(q, NULL);
+      pcb_set_v0(q, UNKNPID);
+      kwakeup_pcb(q);
+    }
+  }
+}
+
 /**
  * Search for the message with a specific filter
  * \private
@@ -286,15 +651,12 @@ search_msg_filtered(msg_filter filter, int32_t filtervalue, msg * m,
 int32_t
 copy_mls(mls * src, mls * dest)
 {
-  int             i;
-  for (i = 0; i < MAX_MSG; i++)
-    copy_msg(&src->ls[i], &dest->ls[i]);
-  dest->status = src->status;
-  dest->filter = src->filter;
-  dest->filtervalue = src->filtervalue;
-  dest->timeout = src->timeout;
-  dest->length = src->length;
-  dest->in = src->in;
-  dest->out = src->out;
+  uint32_t       *s = (uint32_t *) src;
+  uint32_t       *d = (uint32_t *) dest;
+  uint32_t        i;
+
+  for (i = 0; i < sizeof(mls) / sizeof(uint32_t); i++)
+    d[i] = s[i];
+
   return OMGROXX;
 }
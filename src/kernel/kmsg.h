@@ -39,24 +39,85 @@ typedef struct
   msg_t           datatype;     /*!< Sender process identifier. */
 } msg;
 
+/**
+ * @brief Number of types of message (msg_t)
+ */
+#define MSG_TYPES 3
+
+/**
+ * @brief Number of priorities of message, at most 32: one bit each in a
+ * word of mls.pmap
+ */
+#define MSG_PRIS (MAX_MPRI - MIN_MPRI + 1)
+
+/**
+ * @brief Number of lists of the index by sender, a power of 2
+ */
+#define MSG_BUCKETS 32
+
+/**
+ * @brief End of a list of slots
+ */
+#define MSG_NIL -1
+
+/**
+ * @brief The indexes of a mailbox: each message is in one list of each
+ */
+enum
+{
+  MBY_ALL,                      /*!< All the messages */
+  MBY_PRI,                      /*!< The messages of a type and a priority */
+  MBY_SDR,                      /*!< The messages of a type from senders of the same bucket, by priority */
+  MSG_INDEXES
+};
+
+/**
+ * \struct mlist
+ * \brief A list of messages of a mailbox, linked by slot number.
+ */
+typedef struct
+{
+  int8_t          first;        /*!< first slot, MSG_NIL if empty */
+  int8_t          last;         /*!< last slot, MSG_NIL if empty */
+} mlist;
+
+/**
+ * \struct mslot
+ * \brief A slot of a mailbox: a message and its links in each index
+ */
+typedef struct
+{
+  msg             m;            /*!< the message */
+  int8_t          next[MSG_INDEXES];    /*!< next slot in each index, the free slots are linked by next[MBY_ALL] */
+  int8_t          prev[MSG_INDEXES];    /*!< previous slot in each index */
+} mslot;
+
 /**
  * \struct mls
  * \brief Message list representation.
  *
- * A message list is represented as an array with two pointers to
- * simulate a fifo. out is the index of first element to read and
- * in is the index of the array where to push the next element.
+ * The messages are in a pool of MAX_MSG slots. Each one is linked in 3
+ * lists: all the messages in arrival order, the ones of its type and
+ * priority in arrival order, and the ones of its type and sender (a bucket
+ * of senders) by priority then arrival. A bitmap per type tells which
+ * priorities have messages. So a receive takes the message of highest
+ * priority that passes its filter, the oldest one first, from the head of
+ * a list without looking at the others.
  */
 typedef struct
 {
-  msg             ls[MAX_MSG];  /*!< list of messages. */
+  mslot           ls[MAX_MSG];  /*!< slots of the messages. */
+  mlist           all;          /*!< all the messages */
+  mlist           bypri[MSG_TYPES][MSG_PRIS];   /*!< messages by type and priority */
+  uint32_t        pmap[MSG_TYPES];      /*!< bit i set while bypri[type][i] is not empty */
+  mlist           bysdr[MSG_BUCKETS];   /*!< messages by type and sender, hashed */
+  int8_t          free;         /*!< first free slot */
   int32_t         status;       /*!< the status of the list (type of message expected, see above). */
   uint32_t        length;       /*!< number of elements */
-  uint32_t        in;           /*!< index where to push */
-  uint32_t        out;          /*!< first element to pop */
   msg_filter      filter;       /*!< filter type */
   int32_t         filtervalue;  /*!< value of the filter */
   int32_t         timeout;      /*!< timeout before cancelling the receiving */
+  msg_arg        *arg;          /*!< where the waiting receiver wants the message */
 } mls;
 
 /**
@@ -80,7 +141,7 @@ uint32_t        push_mls(mls * m, msg * mess);
 
 /**
  * \fn uint32_t pop_mls(mls* m, msg *mess)
- * \brief pop the message from the beginning of the list
+ * \brief pop the oldest message of the list
  *
  * \param m the list of messages
  * \param mess the list of messages
@@ -88,6 +149,22 @@ uint32_t        push_mls(mls * m, msg * mess);
  */
 uint32_t        pop_mls(mls * m, msg * mess);
 
+/**
+ * \fn int32_t take_mls(mls *m, msg_filter filter, int32_t filtervalue, msg_t datatype, msg *mess)
+ * \brief take the message of a type that passes a filter, of highest
+ * priority then oldest. The others stay in the list
+ *
+ * \param m the list of messages
+ * \param filter the type of the filter
+ * \param filtervalue the value of the filter
+ * \param datatype the type of the message
+ * \param mess where to copy the message
+ * \return OMGROXX, NOTFOUND if no message passes the filter, INVARG if the
+ * type or the priority is out of range
+ */
+int32_t         take_mls(mls * m, msg_filter filter, int32_t filtervalue,
+                         msg_t datatype, msg * mess);
+
 /**
  * \fn int32_t create_msg(msg *m, uint32_t sdr_pid, uint32_t recv_pid, uint32_t pri, void *data, msg_t datatype)
  * \brief create the message object with the given values
@@ -125,15 +202,91 @@ int32_t         send_msg(uint32_t sdr_pid, msg_arg * args);
 
 /**
  * \fn int32_t recv_msg(uint32_t sdr_pid, msg_arg *args)
- * \brief receive a message according to the specified arguments.
- * Could be blocked until the message comes.
+ * \brief receive a message according to the specified arguments, if it is
+ * already in the mailbox.
  *
  * \param recv_pid the pid of the receiver
  * \param args the arguments
- * \return an error code or the pid of the sender
+ * \return the pid of the sender, NOTFOUND if there is no such message, or
+ * an error code
  */
 int32_t         recv_msg(uint32_t recv_pid, msg_arg * args);
 
+/**
+ * \fn int32_t recv_wait(uint32_t recv_pid, msg_arg *args)
+ * \brief receive a message, wait for it if it is not in the mailbox.
+ *
+ * The current process waits with the state WAITING_MSG, in plssleeping if
+ * args->timeout is more than 0 (in ms), in plswaiting otherwise. The sender
+ * of a message that passes the filter gives it directly: it writes the data
+ * in args and the pid of the sender in the v0 register of the receiver, and
+ * wakes it up. When the timeout ends first, the receiver gets NOTFOUND.
+ *
+ * \param recv_pid the pid of the receiver, the current process
+ * \param args the arguments
+ * \return the pid of the sender, NOTFOUND if the process waits, or an
+ * error code
+ */
+int32_t         recv_wait(uint32_t recv_pid, msg_arg * args);
+
+/**
+ * \fn void recv_cancel(mls * box)
+ * \brief the receiver does not wait for a message any more: its msg_arg, on
+ * its stack, is not used again
+ *
+ * \param box the mailbox of the receiver
+ */
+void            recv_cancel(mls * box);
+
+/**
+ * \fn int32_t call_msg(uint32_t sdr_pid, uint32_t pid, int32_t req, int32_t *reply)
+ * \brief call a server: send it a request and wait for its reply.
+ *
+ * The caller waits in plswaiting and lends its priority to the server. If
+ * the server waits for a call (WAITING_CALL), it gets the request at once
+ * and takes the cpu straight away (see sched_handoff), the caller waits
+ * with the state WAITING_REPLY. Otherwise the caller waits with the state
+ * CALLING until the server takes its request. The reply is written in
+ * *reply and OMGROXX in the v0 register of the caller, UNKNPID if the
+ * server terminates first.
+ *
+ * \param sdr_pid the pid of the caller, the current process
+ * \param pid the pid of the server
+ * \param req the request
+ * \param reply where to write the reply
+ * \return FAILNOOB if the process waits, or an error code
+ */
+int32_t         call_msg(uint32_t sdr_pid, uint32_t pid, int32_t req,
+                         int32_t * reply);
+
+/**
+ * \fn int32_t reply_wait(uint32_t pid, int32_t client, int32_t rep, int32_t *req)
+ * \brief reply to a client, then take the next call.
+ *
+ * The oldest call not taken yet is taken at once. Otherwise the server
+ * waits with the state WAITING_CALL in plswaiting, and the client takes
+ * the cpu straight away (see sched_handoff). The caller that comes then
+ * writes its request in *req and its pid in the v0 register of the server.
+ *
+ * \param pid the pid of the server, the current process
+ * \param client the pid of the client to reply to, less than 0 for none
+ * \param rep the reply
+ * \param req where to write the next request, NULL to only reply
+ * \return the pid of the client of the next request, FAILNOOB if the
+ * process waits, OMGROXX if req is NULL, UNKNPID if client does not wait
+ * for a reply of this server
+ */
+int32_t         reply_wait(uint32_t pid, int32_t client, int32_t rep,
+                           int32_t * req);
+
+/**
+ * \fn void call_orphan(uint32_t pid)
+ * \brief a server terminates, its clients get UNKNPID and wake up
+ *
+ * \param pid the pid of the server
+ */
+void            call_orphan(uint32_t pid);
+
 /**
  * \fn bool search_msg_filtered(msg_filter filter, int32_t filtervalue, msg *m, msg_t datatype)
  * \brief receive a message according to the specified arguments.
@@ -50,6 +50,76 @@ pcb_get_pri(pcb * p)
   return p->pri;
 }
 
+/**
+ * \private
+ * @brief Get the effective priority of the process
+ */
+uint32_t
+pcb_get_epri(pcb * p)
+{
+  return p->epri;
+}
+
+/**
+ * \private
+ * @brief Get the level of the process in the multi-level feedback queue
+ */
+uint32_t
+pcb_get_level(pcb * p)
+{
+  return p->level;
+}
+
+/**
+ * \private
+ * @brief Get the priority lent to the process by the ones waiting for it
+ */
+uint32_t
+pcb_get_ipri(pcb * p)
+{
+  return p->ipri;
+}
+
+/**
+ * \private
+ * @brief Get the process this one waits for
+ */
+pcb            *
+pcb_get_blocker(pcb * p)
+{
+  return p->blocker;
+}
+
+/**
+ * \private
+ * @brief Get the pass of the process in the stride scheduler
+ */
+uint32_t
+pcb_get_pass(pcb * p)
+{
+  return p->pass;
+}
+
+/**
+ * \private
+ * @brief Get the lowest address of the stack of the process
+ */
+uint32_t       *
+pcb_get_stack(pcb * p)
+{
+  return p->stack;
+}
+
+/**
+ * \private
+ * @brief Get the size of the stack of the process
+ */
+uint32_t
+pcb_get_stack_size(pcb * p)
+{
+  return p->stack_size;
+}
+
 /**
  * \private
  * \brief Get the messages of the process
@@ -62,6 +132,16 @@ pcb_get_messages(pcb * p)
   return &p->messages;
 }
 
+/**
+ * \private
+ * \brief Get the scheduling statistics of the process
+ */
+pstat          *
+pcb_get_stat(pcb * p)
+{
+  return &p->stat;
+}
+
 /**
  * \private
  * Get the list where the process is
@@ -94,13 +174,32 @@ pcb_get_prev(pcb * p)
 
 /**
  * \private
- * @brief Return a pointer to the list of supervised process. !!!WARNING!!!
- * Don't give this pointer to anybody !
+ * @brief Return the supervisor of the process
  */
-int32_t        *
-pcb_get_supervised(pcb * p)
+pcb            *
+pcb_get_parent(pcb * p)
+{
+  return p->parent;
+}
+
+/**
+ * \private
+ * @brief Return the first process supervised by this one
+ */
+pcb            *
+pcb_get_child(pcb * p)
+{
+  return p->child;
+}
+
+/**
+ * \private
+ * @brief Return the next process supervised by the same supervisor
+ */
+pcb            *
+pcb_get_sibling(pcb * p)
 {
-  return p->supervised;
+  return p->sibling;
 }
 
 /**
@@ -110,7 +209,10 @@ pcb_get_supervised(pcb * p)
 int32_t
 pcb_get_supervisor(pcb * p)
 {
-  return p->supervisor;
+  if (p->parent == NULL)
+    return -1;
+
+  return p->parent->pid;
 }
 
 /**
@@ -172,7 +274,7 @@ pcb_get_state(pcb * p)
 
 /**
  * \private
- * @brief return the sleeping time of the process. Not relevante if the process
+ * @brief return the wake up date of the process. Not relevante if the process
  * is not sleeping.
  */
 uint32_t
@@ -192,6 +294,56 @@ pcb_get_waitfor(pcb * p)
   return p->waitfor;
 }
 
+/**
+ * \private
+ * @brief return where the return value of the waited process is written
+ */
+int32_t        *
+pcb_get_wstatus(pcb * p)
+{
+  return p->wstatus;
+}
+
+/**
+ * \private
+ * @brief return the pids the process waits for
+ */
+int32_t        *
+pcb_get_wset(pcb * p)
+{
+  return p->wset;
+}
+
+/**
+ * \private
+ * @brief return the number of pids the process waits for
+ */
+uint32_t
+pcb_get_wset_size(pcb * p)
+{
+  return p->wset_size;
+}
+
+/**
+ * \private
+ * @brief return where the word the process waits for in a call is written
+ */
+int32_t        *
+pcb_get_ipcbuf(pcb * p)
+{
+  return p->ipcbuf;
+}
+
+/**
+ * \private
+ * @brief return the request of a call
+ */
+int32_t
+pcb_get_ipcword(pcb * p)
+{
+  return p->ipcword;
+}
+
 /**
  * \private
  * @brief return the last error encounter by the process
@@ -236,19 +388,47 @@ pcb_reset(pcb * p)
   pcb_set_pid(p, 0);
   pcb_set_name(p, "");
   pcb_set_pri(p, 0);
-  pcb_reset_supervised(p);
-  pcb_set_supervisor(p, -1);
+  pcb_set_level(p, 0);
+  pcb_set_ipri(p, MIN_PRI);
+  pcb_set_blocker(p, NULL);
+  pcb_set_pass(p, 0);
+  pcb_set_stack(p, NULL, 0);
+  p->parent = NULL;
+  p->child = NULL;
+  p->sibling = NULL;
+  p->psibling = NULL;
   //pcb_set_state(p, 0);
   //pcb_set_sleep(p, 0);
   //pcb_set_waitfor(p, 0);
+  pcb_set_wstatus(p, NULL);
+  pcb_set_wset(p, NULL, 0);
+  pcb_set_ipcbuf(p, NULL);
+  pcb_set_ipcword(p, 0);
   reset_mls(&p->messages);
+  pcb_reset_stat(p);
   pcb_set_error(p, OMGROXX);
   pcb_set_empty(p, TRUE);
+  pcb_set_head(p, NULL);
   pcb_set_next(p, NULL);
   pcb_set_prev(p, NULL);
   pcb_set_ret(p, 0);
 }
 
+/**
+ * \private
+ * @brief Reset the scheduling statistics of the pcb
+ */
+void
+pcb_reset_stat(pcb * p)
+{
+  p->stat.ready_date = 0;
+  p->stat.run_date = 0;
+  p->stat.run_time = 0;
+  p->stat.wait_time = 0;
+  p->stat.vol_switch = 0;
+  p->stat.invol_switch = 0;
+}
+
 /**
  * \private
  * @brief Copy a pcb in an other
@@ -256,21 +436,22 @@ pcb_reset(pcb * p)
 void
 pcb_cpy(pcb * src, pcb * dest)
 {
-  int32_t        *s, i;
-
   pcb_set_pid(dest, pcb_get_pid(src));
   pcb_set_name(dest, pcb_get_name(src));
   pcb_set_pri(dest, pcb_get_pri(src));
-  pcb_reset_supervised(dest);
-  s = pcb_get_supervised(src);
-
-  for (i = 0; i < MAXPCB; i++)
-    pcb_set_supervised(dest, s[i]);
-
-  pcb_set_supervisor(dest, pcb_get_supervisor(src));
+  pcb_set_epri(dest, pcb_get_epri(src));
+  pcb_set_level(dest, pcb_get_level(src));
+  pcb_set_ipri(dest, pcb_get_ipri(src));
+  pcb_set_blocker(dest, pcb_get_blocker(src));
+  pcb_set_pass(dest, pcb_get_pass(src));
+  pcb_set_stack(dest, pcb_get_stack(src), pcb_get_stack_size(src));
   pcb_set_state(dest, pcb_get_state(src));
   pcb_set_sleep(dest, pcb_get_sleep(src));
   pcb_set_waitfor(dest, pcb_get_waitfor(src));
+  pcb_set_wstatus(dest, pcb_get_wstatus(src));
+  pcb_set_wset(dest, pcb_get_wset(src), pcb_get_wset_size(src));
+  pcb_set_ipcbuf(dest, pcb_get_ipcbuf(src));
+  pcb_set_ipcword(dest, pcb_get_ipcword(src));
   pcb_set_error(dest, pcb_get_error(src));
   pcb_set_empty(dest, pcb_get_empty(src));
   pcb_set_register(dest, &(src->registers));
@@ -310,6 +491,68 @@ void
 pcb_set_pri(pcb * p, int32_t pri)
 {
   p->pri = pri;
+  p->epri = pri;
+}
+
+/**
+ * \private
+ * @brief Set the effective priority of the process
+ */
+void
+pcb_set_epri(pcb * p, uint32_t epri)
+{
+  p->epri = epri;
+}
+
+/**
+ * \private
+ * @brief Set the level of the process in the multi-level feedback queue
+ */
+void
+pcb_set_level(pcb * p, uint32_t level)
+{
+  p->level = level;
+}
+
+/**
+ * \private
+ * @brief Set the priority lent to the process by the ones waiting for it
+ */
+void
+pcb_set_ipri(pcb * p, uint32_t ipri)
+{
+  p->ipri = ipri;
+}
+
+/**
+ * \private
+ * @brief Set the process this one waits for
+ */
+void
+pcb_set_blocker(pcb * p, pcb * blocker)
+{
+  p->blocker = blocker;
+}
+
+/**
+ * \private
+ * @brief Set the pass of the process in the stride scheduler
+ */
+void
+pcb_set_pass(pcb * p, uint32_t pass)
+{
+  p->pass = pass;
+}
+
+/**
+ * \private
+ * @brief Set the stack of the process
+ */
+void
+pcb_set_stack(pcb * p, uint32_t * stack, uint32_t size)
+{
+  p->stack = stack;
+  p->stack_size = size;
 }
 
 /**
@@ -348,86 +591,72 @@ pcb_set_prev(pcb * p, pcb * prev)
 
 /**
  * \private
- * @brief Reset the list of supervised process to -1.
+ * @brief Add a process to the supervised processes of an other one. It goes
+ * at the front of the list.
  */
 void
-pcb_reset_supervised(pcb * p)
+pcb_add_child(pcb * p, pcb * child)
 {
-  uint32_t        i;
+  child->parent = p;
+  child->psibling = NULL;
+  child->sibling = p->child;
 
-  /*
-   * We try to found if the process is already in the list
-   * At the same time we save the first empty space
-   */
-  for (i = 0; i < MAXPCB; i++)
-    p->supervised[i] = -1;
+  if (p->child != NULL)
+    p->child->psibling = child;
+
+  p->child = child;
 }
 
 /**
  * \private
- * @brief Add a pid to the list of supervised process.
+ * @brief Remove a process from the supervised processes of its supervisor
  */
-int32_t
-pcb_set_supervised(pcb * p, int32_t pid)
+void
+pcb_rm_child(pcb * child)
 {
-  int32_t         i;
-  int32_t         first_empty;
+  if (child->parent == NULL)
+    return;
 
-  /*
-   * We try to found if the process is already in the list
-   * At the same time we save the first empty space
-   */
-  i = 0;
-  first_empty = -1;
-  while (p->supervised[i] != pid && i < MAXPCB)
-  {
-    if (first_empty == -1 && p->supervised[i] == -1)
-      first_empty = i;
-    i++;
-  }
-
-  /*
-   * We reach i and first_empty stayed at -1 : out of memory !
-   */
-  if (i >= MAXPCB && first_empty == -1)
-    return OUTOMEM;
-
-  /*
-   * Already inside, not a fail !
-   */
-  if (first_empty == -1 && p->supervised[i] == pid)
-    return OMGROXX;
+  if (child->psibling != NULL)
+    child->psibling->sibling = child->sibling;
+  else
+    child->parent->child = child->sibling;
 
-  /*
-   * Any other case
-   */
-  p->supervised[first_empty] = pid;
+  if (child->sibling != NULL)
+    child->sibling->psibling = child->psibling;
 
-  return OMGROXX;
+  child->parent = NULL;
+  child->sibling = NULL;
+  child->psibling = NULL;
 }
 
 /**
  * \private
- * @brief Remove a pid from the list of supervised process.
+ * @brief Give all the supervised processes of a process to an other one.
+ * Each one gets its new supervisor, then the list is put in front of the
+ * one of p.
  */
 void
-pcb_rm_supervised(pcb * p, uint32_t pid)
+pcb_adopt(pcb * p, pcb * old)
 {
-  uint32_t        i;
+  pcb            *c, *last = NULL;
 
-  i = 0;
-  while (p->supervised[i] != pid && i < MAXPCB)
-    i++;
+  if (p == old || old->child == NULL)
+    return;
 
-  /*
-   * We found it, we remove it
-   */
-  if (p->supervised[i] == pid)
-    p->supervised[i] = -1;
+  for (c = old->child; c != NULL; c = c->sibling)
+  {
+    c->parent = p;
+    last = c;
+  }
 
-  /*
-   * We did not found it. But hey not anymore :)
-   */
+  last->sibling = p->child;
+
+  if (p->child != NULL)
+    p->child->psibling = last;
+
+  p->child = old->child;
+  old->child = NULL;
 }
 
 /**
@@ -460,16 +689,6 @@ pcb_set_register(pcb * p, registers_t * regs)
   p->registers.gp_reg = regs->gp_reg;
 }
 
-/**
- * \private
- * @brief Set the supervisor of the process
- */
-void
-pcb_set_supervisor(pcb * p, int32_t pid)
-{
-  p->supervisor = pid;
-}
-
 /**
  * \private
  * @brief Set the current state of the process
@@ -512,7 +731,7 @@ pcb_set_v0(pcb * p, uint32_t v0)
 
 /**
  * \private
- * @brief SSet the sleeping time of the process. Not relevante if the process
+ * @brief Set the wake up date of the process. Not relevante if the process
  * is not sleeping.
  */
 void
@@ -532,6 +751,47 @@ pcb_set_waitfor(pcb * p, uint32_t pid)
   p->waitfor = pid;
 }
 
+/**
+ * \private
+ * @brief Set where the return value of the waited process is written
+ */
+void
+pcb_set_wstatus(pcb * p, int32_t * status)
+{
+  p->wstatus = status;
+}
+
+/**
+ * \private
+ * @brief Set the pids the process waits for
+ */
+void
+pcb_set_wset(pcb * p, int32_t * pids, uint32_t size)
+{
+  p->wset = pids;
+  p->wset_size = size;
+}
+
+/**
+ * \private
+ * @brief Set where the word the process waits for in a call is written
+ */
+void
+pcb_set_ipcbuf(pcb * p, int32_t * buf)
+{
+  p->ipcbuf = buf;
+}
+
+/**
+ * \private
+ * @brief Set the request of a call
+ */
+void
+pcb_set_ipcword(pcb * p, int32_t word)
+{
+  p->ipcword = word;
+}
+
 /**
  * \private
  * @brief SSet the last error encounter by the process
@@ -30,6 +30,10 @@ enum
   WAITING_IO,
   DOING_IO,
   WAITING_PCB,
+  WAITING_MSG,
+  WAITING_CALL,
+  CALLING,
+  WAITING_REPLY,
   OMG_ZOMBIE
 };
 #endif
@@ -43,6 +47,20 @@ enum
  */
 struct _PLS;
 
+/**
+ * \struct pstat
+ * \brief Scheduling statistics of a process (see kstat.h)
+ */
+typedef struct
+{
+  uint32_t        ready_date;   /*!< Value of count when it became READY */
+  uint32_t        run_date;     /*!< Value of count when it became RUNNING */
+  uint32_t        run_time;     /*!< Time spent running, in us */
+  uint32_t        wait_time;    /*!< Time spent ready but not running, in us */
+  uint32_t        vol_switch;   /*!< Times it gave the cpu (block, sleep, wait) */
+  uint32_t        invol_switch; /*!< Times it was preempted */
+} pstat;
+
 /**
  * \struct pcb
  * \brief Process representation.
@@ -57,15 +75,30 @@ typedef struct _PCB
   uint32_t        pid;          /*!< Process identifier. */
   char            name[ARG_SIZE];       /*!< Process name. */
   uint32_t        pri;          /*!< Process priority. */
-  int32_t         supervised[MAXPCB];   /*!< List of supervised processes. */
-  int32_t         supervisor;   /*!< supervisor. */
+  uint32_t        epri;         /*!< Effective priority, the one used by the scheduler. */
+  uint32_t        level;        /*!< Level in the multi-level feedback queue. */
+  uint32_t        ipri;         /*!< Priority lent by the processes waiting for this one. */
+  struct _PCB    *blocker;      /*!< Process this one waits for, it lends it its priority. */
+  uint32_t        pass;         /*!< Virtual time of the stride scheduler. */
+  uint32_t       *stack;        /*!< Lowest address of the stack. */
+  uint32_t        stack_size;   /*!< Size of the stack, in words. */
+  struct _PCB    *parent;       /*!< Supervisor, NULL if none. */
+  struct _PCB    *child;        /*!< First supervised process. */
+  struct _PCB    *sibling;      /*!< Next process supervised by the same parent. */
+  struct _PCB    *psibling;     /*!< Previous process supervised by the same parent. */
   mls             messages;     /*!< List of incoming messages. */
+  pstat           stat;         /*!< Scheduling statistics. */
   struct _PLS    *head;
   struct _PCB    *prev;         /*!< pointer to the previous process(pcb) in the list where the process is */
   struct _PCB    *next;         /*!< Pointer to the next process(pcb) in the list where the process is. */
   uint32_t        state;        /*!< Current state of the process */
-  uint32_t        sleep;        /*!< Time to sleep, if state == SLEEPING */
-  uint32_t        waitfor;      /*!< pid of the process you are waiting for */
+  uint32_t        sleep;        /*!< Wake up date (value of count), if state == SLEEPING */
+  uint32_t        waitfor;      /*!< pid of the process you are waiting for, or WAIT_ANY, WAIT_SET */
+  int32_t        *wstatus;      /*!< Where to write the return value of the waited process */
+  int32_t        *wset;         /*!< pids waited for, if waitfor == WAIT_SET */
+  uint32_t        wset_size;    /*!< Number of pids in wset */
+  int32_t        *ipcbuf;       /*!< Where to write the request or the reply the process waits for, in a call */
+  int32_t         ipcword;      /*!< Request of a call not taken yet, if state == CALLING */
   int32_t         error;        /*!< Last error the process encountered. */
   bool            empty;        /*!< is this pcb empty ? */
   int32_t         ret;          /*!< return value */
@@ -101,6 +134,57 @@ char           *pcb_get_name(pcb * p);
  */
 uint32_t        pcb_get_pri(pcb * p);
 
+/**
+ * @brief Get the effective priority of the process, the one used to
+ * schedule it.
+ * @param the pcb to read
+ * @return the effective priority of the pcb
+ */
+uint32_t        pcb_get_epri(pcb * p);
+
+/**
+ * @brief Get the level of the process in the multi-level feedback queue
+ * @param the pcb to read
+ * @return the level of the pcb
+ */
+uint32_t        pcb_get_level(pcb * p);
+
+/**
+ * @brief Get the priority lent to the process by the ones waiting for it
+ * @param the pcb to read
+ * @return the inherited priority of the pcb
+ */
+uint32_t        pcb_get_ipri(pcb * p);
+
+/**
+ * @brief Get the process this one waits for
+ * @param the pcb to read
+ * @return the blocking pcb, NULL if the process does not wait for anyone
+ */
+pcb            *pcb_get_blocker(pcb * p);
+
+/**
+ * @brief Get the pass of the process, its virtual time in the stride
+ * scheduler
+ * @param the pcb to read
+ * @return the pass of the pcb
+ */
+uint32_t        pcb_get_pass(pcb * p);
+
+/**
+ * @brief Get the lowest address of the stack of the process
+ * @param the pcb to read
+ * @return the stack, NULL if the process has none
+ */
+uint32_t       *pcb_get_stack(pcb * p);
+
+/**
+ * @brief Get the size of the stack of the process
+ * @param the pcb to read
+ * @return the size of the stack, in words
+ */
+uint32_t        pcb_get_stack_size(pcb * p);
+
 /**
  * \brief Get the messages of the process
  * \param the pcb to read
@@ -108,6 +192,13 @@ uint32_t        pcb_get_pri(pcb * p);
  */
 mls            *pcb_get_messages(pcb * p);
 
+/**
+ * \brief Get the scheduling statistics of the process
+ * \param the pcb to read
+ * @return the statistics of the pcb
+ */
+pstat          *pcb_get_stat(pcb * p);
+
 /**
  * Get the list where the process is
  * \param the pcb to read
@@ -130,12 +221,26 @@ pcb            *pcb_get_next(pcb * p);
 pcb            *pcb_get_prev(pcb * p);
 
 /**
- * @brief Return a pointer to the list of supervised process. !!!WARNING!!!
- * Don't give this pointer to anybody !
+ * @brief Return the supervisor of the process
  * @param the pcb to read
- * @return a pointer to the array of supervised element
+ * @return the supervisor, NULL if none
  */
-int32_t        *pcb_get_supervised(pcb * p);
+pcb            *pcb_get_parent(pcb * p);
+
+/**
+ * @brief Return the first process supervised by this one. The others
+ * follow with pcb_get_sibling.
+ * @param the pcb to read
+ * @return the first supervised process, NULL if none
+ */
+pcb            *pcb_get_child(pcb * p);
+
+/**
+ * @brief Return the next process supervised by the same supervisor
+ * @param the pcb to read
+ * @return the next supervised process, NULL if none
+ */
+pcb            *pcb_get_sibling(pcb * p);
 
 /**
  * @brief Return the supervisor of the process, if any return -1
@@ -181,10 +286,10 @@ uint32_t        pcb_get_v0(pcb * p);
 uint32_t        pcb_get_state(pcb * p);
 
 /**
- * @brief return the sleeping time of the process. Not relevante if the process
+ * @brief return the wake up date of the process. Not relevante if the process
  * is not sleeping.
  * @param the pcb to read
- * @return the time to sleep
+ * @return the value of count when the process must wake up
  */
 uint32_t        pcb_get_sleep(pcb * p);
 
@@ -196,6 +301,44 @@ uint32_t        pcb_get_sleep(pcb * p);
  */
 uint32_t        pcb_get_waitfor(pcb * p);
 
+/**
+ * @brief return where the return value of the waited process is written.
+ * Not relevante if the process don't wait anybody
+ * @param the pcb to read
+ * @return the address of the status, NULL if none
+ */
+int32_t        *pcb_get_wstatus(pcb * p);
+
+/**
+ * @brief return the pids the process waits for, if it waits for a set
+ * @param the pcb to read
+ * @return the array of pids
+ */
+int32_t        *pcb_get_wset(pcb * p);
+
+/**
+ * @brief return the number of pids the process waits for, if it waits for a
+ * set
+ * @param the pcb to read
+ * @return the size of the array of pids
+ */
+uint32_t        pcb_get_wset_size(pcb * p);
+
+/**
+ * @brief return where the word the process waits for in a call is written:
+ * the reply for a client, the next request for a server
+ * @param the pcb to read
+ * @return the address of the word, NULL if none
+ */
+int32_t        *pcb_get_ipcbuf(pcb * p);
+
+/**
+ * @brief return the request of a call, while the server has not taken it
+ * @param the pcb to read
+ * @return the request
+ */
+int32_t         pcb_get_ipcword(pcb * p);
+
 /**
  * @brief return the last error encounter by the process
  * @param the pcb to read
@@ -235,12 +378,19 @@ void            pcb_set_register(pcb * p, registers_t * regs);
 void            pcb_reset(pcb * p);
 
 /**
- * @brief Copy a pcb in an other
+ * @brief Copy a pcb in an other. The links of the lists and of the
+ * supervision are not copied.
  * @param the source pcb
  * @param the destination pcb
  */
 void            pcb_cpy(pcb * src, pcb * dest);
 
+/**
+ * @brief Reset the scheduling statistics of the pcb
+ * @param the pcb to write
+ */
+void            pcb_reset_stat(pcb * p);
+
 /**
  * @brief Set the pid of the pcb
  * @param the pcb to write
@@ -256,12 +406,57 @@ void            pcb_set_pid(pcb * p, uint32_t pid);
 void            pcb_set_name(pcb * p, char *name);
 
 /**
- * @brief Set the priority of the process
+ * @brief Set the priority of the process. The effective priority is set
+ * to it too.
  * @param the pcb to write
  * @param the new priority to set
  */
 void            pcb_set_pri(pcb * p, int32_t pri);
 
+/**
+ * @brief Set the effective priority of the process
+ * @param the pcb to write
+ * @param the new effective priority to set
+ */
+void            pcb_set_epri(pcb * p, uint32_t epri);
+
+/**
+ * @brief Set the level of the process in the multi-level feedback queue
+ * @param the pcb to write
+ * @param the new level to set
+ */
+void            pcb_set_level(pcb * p, uint32_t level);
+
+/**
+ * @brief Set the priority lent to the process by the ones waiting for it
+ * @param the pcb to write
+ * @param the new inherited priority to set
+ */
+void            pcb_set_ipri(pcb * p, uint32_t ipri);
+
+/**
+ * @brief Set the process this one waits for
+ * @param the pcb to write
+ * @param the blocking pcb, or NULL
+ */
+void            pcb_set_blocker(pcb * p, pcb * blocker);
+
+/**
+ * @brief Set the pass of the process, its virtual time in the stride
+ * scheduler
+ * @param the pcb to write
+ * @param the pass
+ */
+void            pcb_set_pass(pcb * p, uint32_t pass);
+
+/**
+ * @brief Set the stack of the process
+ * @param the pcb to write
+ * @param the lowest address of the stack, or NULL
+ * @param the size of the stack, in words
+ */
+void            pcb_set_stack(pcb * p, uint32_t * stack, uint32_t size);
+
 /**
  * \brief Set the list in which the process is
  * \param the pcb to read
@@ -284,33 +479,26 @@ void            pcb_set_next(pcb * p, pcb * next);
 void            pcb_set_prev(pcb * p, pcb * prev);
 
 /**
- * @brief Reset the list of supervised process to -1.
- * @param the pcb to write
+ * @brief Add a process to the supervised processes of an other one. It
+ * must not have a supervisor yet.
+ * @param the supervisor
+ * @param the process to supervise
  */
-void            pcb_reset_supervised(pcb * p);
+void            pcb_add_child(pcb * p, pcb * child);
 
 /**
- * @brief Add a pid to the list of supervised process.
- * @param the pcb to write
- * @param pid to add in the supervised list
- * @return OMGROXX if everything goes well, OUTOFMEM if
- * there is no empty space
+ * @brief Remove a process from the supervised processes of its supervisor,
+ * if it has one.
+ * @param the supervised process
  */
-int32_t         pcb_set_supervised(pcb * p, int32_t pid);
+void            pcb_rm_child(pcb * child);
 
 /**
- * @brief Remove a pid from the list of supervised process.
- * @param the pcb to write
- * @param the pid to remove
+ * @brief Give all the supervised processes of a process to an other one
+ * @param the new supervisor
+ * @param the old supervisor
  */
-void            pcb_rm_supervised(pcb * p, uint32_t pid);
-
-/**
- * @brief Set the supervisor of the process
- * @param the pcb to write
- * @param the pid to set as supervisor
- */
-void            pcb_set_supervisor(pcb * p, int32_t pid);
+void            pcb_adopt(pcb * p, pcb * old);
 
 /**
  * @brief Set the current state of the process
@@ -341,10 +529,10 @@ void            pcb_set_sp(pcb * p, uint32_t sp);
 void            pcb_set_v0(pcb * p, uint32_t v0);
 
 /**
- * @brief Set the sleeping time of the process. Not relevante if the process
+ * @brief Set the wake up date of the process. Not relevante if the process
  * is not sleeping.
  * @param the pcb to write
- * @param the new time to set
+ * @param the value of count when the process must wake up
  */
 void            pcb_set_sleep(pcb * p, uint32_t time);
 
@@ -356,6 +544,35 @@ void            pcb_set_sleep(pcb * p, uint32_t time);
  */
 void            pcb_set_waitfor(pcb * p, uint32_t pid);
 
+/**
+ * @brief Set where the return value of the waited process is written
+ * @param the pcb to write
+ * @param the address of the status, or NULL
+ */
+void            pcb_set_wstatus(pcb * p, int32_t * status);
+
+/**
+ * @brief Set the pids the process waits for, when waitfor is WAIT_SET
+ * @param the pcb to write
+ * @param the array of pids
+ * @param its size
+ */
+void            pcb_set_wset(pcb * p, int32_t * pids, uint32_t size);
+
+/**
+ * @brief Set where the word the process waits for in a call is written
+ * @param the pcb to write
+ * @param the address of the word, or NULL
+ */
+void            pcb_set_ipcbuf(pcb * p, int32_t * buf);
+
+/**
+ * @brief Set the request of a call
+ * @param the pcb to write
+ * @param the request
+ */
+void            pcb_set_ipcword(pcb * p, int32_t word);
+
 /**
  * @brief Set the last error encounter by the process
  * @param the pcb to write
@@ -16,24 +16,23 @@
 #include "kernel.h"
 #include "kinout.h"
 #include "kscheduler.h"
-
-/*
- * Define
- */
-
-/**
- * @brief Size per pcb of the stack. In a number of uint32_t
- */
-#define SIZE_STACK 4096
+#include "ktimer.h"
+#include "ksleep.h"
+#include "kstat.h"
+#include "bitops.h"
+#include "kstack.h"
+#include "kbuf.h"
 
 /*
  * Global variable for this module
  */
 
 /**
- * @brief the next possible pid
+ * @brief Generation of the next pid of each pcb of pmem. The pid of the pcb
+ * pmem[i] is generation * MAXPCB + i: two processes alive never have the
+ * same pid modulo MAXPCB (see pls_find_pid).
  */
-static uint32_t next_pid = 0;
+static uint32_t pid_gen[MAXPCB];
 
 /**
  * @brief number of PCB in the system
@@ -41,20 +40,26 @@ static uint32_t next_pid = 0;
 static uint32_t pcb_counter = 0;
 
 /**
- * @brief A big stack for everybody
+ * @brief The pcb memory
  */
-static uint32_t stack[MAXPCB * SIZE_STACK];
+static pcb      pmem[MAXPCB];
 
 /**
- * @brief Array to hold the used part of the stack. We store -1 if not use,
- * and the pid otherwise
+ * @brief Number of words of the bitmap of the free pcb
  */
-static uint32_t used_stack[MAXPCB];
+#define PMEM_WORDS ((MAXPCB + 31) / 32)
 
 /**
- * @brief The pcb memory
+ * @brief Bytes above the stack pointer of a new process that its first
+ * function may use: with the o32 calling convention, the callee spills its
+ * argument registers a0-a3 in these 16 bytes of the caller's frame
  */
-static pcb      pmem[MAXPCB];
+#define O32_HOME 16
+
+/**
+ * @brief Bitmap of the free pcb of pmem: the bit i is set if pmem[i] is free
+ */
+static uint32_t pmem_free[PMEM_WORDS];
 
 /**
  * @brief the current pcb
@@ -65,10 +70,9 @@ pcb            *current_pcb;
  * \private
  * Privates functions
  */
-int32_t         get_next_pid();
-int32_t        *get_used_stack();
-uint32_t       *allocate_stack(uint32_t pid);
-int32_t         deallocate_stack(uint32_t pid);
+int32_t         get_next_pid(pcb * p);
+uint32_t       *allocate_stack(pcb * p, uint32_t size);
+int32_t         deallocate_stack(pcb * p);
 //pcb*       allocate_pcb();
 
 /*
@@ -97,19 +101,67 @@ set_current_pcb(pcb * p)
   current_pcb = p;
 }
 
-/**
- * \private
- * create a pcb with all the needed value at the specified location
+/*
+ * Reserve a pcb, a pid and a stack for a new process of the program prg.
+ * The process is not ready yet, see proc_start.
  */
-uint32_t
-create_proc(char *name, uint32_t prio, uint32_t argc, char **params)
+static int32_t
+proc_alloc(prgm * prg, uint32_t prio, pcb ** pp)
 {
-  uint32_t       *i, j;
   int32_t         pid;
   pcb            *p;
-  prgm           *prg;
 
-  //kdebug_println("Create process in");
+  if (pcb_counter >= MAXPCB)
+    return OUTOMEM;
+
+  /*
+   * Allocate a pcb
+   */
+  p = alloc_pcb();
+
+  if (p == NULL)
+    return OUTOMEM;
+
+  pcb_reset(p);
+  pcb_set_name(p, prg->name);
+
+  /*
+   * init the program counter
+   */
+  pcb_set_epc(p, (uint32_t) prg->address);
+
+  /*
+   * get a pid
+   */
+  pid = get_next_pid(p);
+
+  if (pid < 0)
+  {
+    dealloc_pcb(p);
+    return pid;                 /* contain an error code */
+  }
+
+  pcb_set_pid(p, pid);
+  pcb_set_pri(p, prio);
+
+  if (allocate_stack(p, prg->stack) == NULL)
+  {
+    dealloc_pcb(p);
+    return OUTOMEM;
+  }
+
+  *pp = p;
+
+  return pid;
+}
+
+/*
+ * Reserve a pcb, a pid and a stack for a new process of the program name
+ */
+static int32_t
+proc_new(char *name, uint32_t prio, pcb ** pp)
+{
+  prgm           *prg;
 
   if (name == NULL)
     return NULLPTR;
@@ -117,222 +169,252 @@ create_proc(char *name, uint32_t prio, uint32_t argc, char **params)
   if (prio > MAX_PRI || prio < MIN_PRI)
     return INVARG;
 
+  /*
+   * Check that the program exist
+   */
+  prg = search_prgm(name);
 
-  if (pcb_counter <= MAXPCB)
-  {
-    /*
-     * Allocate a pcb
-     */
-    p = alloc_pcb();
+  if (prg == NULL)
+    return INVARG;
 
-    if (p == NULL)
-	 {
-	  kprint("Outofmem\n");
-      return OUTOMEM;
-	 }
+  return proc_alloc(prg, prio, pp);
+}
 
-    /*
-     * Reset the pcb
-     */
-    pcb_reset(p);
+/*
+ * Make a new process ready at the date now. Its arguments are at the top of
+ * its stack, the stack pointer is below them and the O32_HOME bytes where
+ * the process spills a0 and a1, aligned on 8 bytes. args is NULL if there
+ * is none.
+ */
+static void
+proc_start(pcb * p, argblock * args, uint32_t now)
+{
+  /*
+   * Set the supervisor of the process, which is the one we ask for the creation
+   * or none if the system ask.
+   */
+  if (current_pcb != NULL)
+    pcb_add_child(current_pcb, p);
 
-    /*
-     * Check that the program exist
-     */
-    prg = search_prgm(name);
+  /*
+   * Set the parameters of the function
+   */
+  if (args != NULL)
+  {
+    pcb_set_sp(p, ((uint32_t) args - O32_HOME) & ~7);
+    p->registers.a_reg[0] = args->argc;
+    p->registers.a_reg[1] = (uint32_t) args;
+  }
+  else
+  {
+    pcb_set_sp(p, ((uint32_t) (pcb_get_stack(p) + pcb_get_stack_size(p))
+                   - O32_HOME) & ~7);
+    p->registers.a_reg[0] = 0;
+    p->registers.a_reg[1] = 0;
+  }
 
-    if (prg == NULL)
-      return INVARG;
+  pcb_set_state(p, READY);
+  pcb_set_error(p, OMGROXX);
+  pcb_set_empty(p, FALSE);
 
-    /*
-     * Set the name
-     */
-    pcb_set_name(p, name);
+  kstat_ready(p, now);
+  rq_add(&rqready, p);
 
-    /*
-     * init the program counter
-     */
-    pcb_set_epc(p, (uint32_t) prg->address);
+  pcb_counter++;
+}
 
-    /*
-     * get a pid
-     */
-    pid = get_next_pid();
+/*
+ * Length of an argument of ARG_SIZE chars, without its '\0'
+ */
+static uint32_t
+arg_len(char *arg)
+{
+  uint32_t        l = 0;
 
-    if (pid < 0)
-      return pid;               /* contain an error code */
+  while (l < ARG_SIZE - 1 && arg[l] != '\0')
+    l++;
 
-    pcb_set_pid(p, pid);        /* set the pid */
+  return l;
+}
 
-    pcb_set_pri(p, prio);       /* set the priority */
+/**
+ * \private
+ * create a pcb with all the needed value at the specified location. The
+ * arguments are packed at the top of the stack: only their chars are
+ * copied, not the whole ARG_SIZE.
+ */
+uint32_t
+create_proc(char *name, uint32_t prio, uint32_t argc, char **params)
+{
+  char           *slot = (char *) params;
+  argblock       *b = NULL;
+  uint32_t        i, l, size;
+  int32_t         pid;
+  char           *d;
+  pcb            *p;
 
-    /*
-     * Set the supervisor of the process, which is the one we ask for the creation
-     * or -1 if the system ask.
-     * This value is in the global variable current_pcb
-     */
-    if (current_pcb != NULL)
-    {
-      pcb_set_supervisor(p, pcb_get_pid(current_pcb));
-      pcb_set_supervised(current_pcb, pid);
-    }
-    else
-      pcb_set_supervisor(p, -1);
+  size = ARG_HEADER;
 
-    /*
-       <<<<<<< HEAD:src/kernel/kprocess.c
-       <<<<<<< HEAD:src/kernel/kprocess.c
-       * Set the parameters of the function
-     */
-    //p->registers.a_reg[0] = (params == NULL) ? 0 : stoi(get_arg(params, 0)) + 1;
-    //p->registers.a_reg[1] = (uint32_t) params;   /* the adresse of the first arg */
+  if (params != NULL)
+  {
+    for (i = 0; i <= argc; i++)
+      size += arg_len(slot + i * ARG_SIZE) + 2;
 
-    if (params != NULL)
-    {
-      p->registers.a_reg[0] = argc + 1;
-      p->registers.a_reg[1] = (uint32_t) params;
-    }
-    else
-    {
-      p->registers.a_reg[0] = 0;
-      p->registers.a_reg[1] = 0;
-    }
+    if (size > ARG_BLOCK)
+      return INVARG;
+  }
 
-    /*
-       * Set the stack pointer
-     */
-    i = allocate_stack(pcb_get_pid(p));
+  pid = proc_new(name, prio, &p);
 
-    if (i == NULL)
-	 {
-	  kprint("Outofmem2\n");
-      return OUTOMEM;
-	 }
+  if (pid < 0)
+    return pid;
 
-    /*
-     * We add the arg on the stack
-     */
-    //kprint("sp set\n");
+  if (params != NULL)
+  {
+    b = (argblock *) (pcb_get_stack(p) + pcb_get_stack_size(p)
+                      - (size + 3) / 4);
+    b->size = size;
+    b->argc = argc + 1;
+    d = b->data;
 
-    if (params != NULL)
+    for (i = 0; i <= argc; i++, slot += ARG_SIZE)
     {
-      //kprint((char *) params);
-      //kprint("params not null\n");
-      //kprint(itos((uint32_t) i, c));
-      //kprint("\n");
-      i = (uint32_t *) ((uint32_t) i - (ARG_SIZE * (argc + 1) * sizeof(char))); /* set the sp after the arg */
-      //kprint(itos((uint32_t) i, c));
-      //kprint("\n");
-      pcb_set_sp(p, (uint32_t) i);      /* set the stack pointer */
-
-      for (j = 0;
-           j < (argc + 1) * (ARG_SIZE * sizeof(char) / sizeof(uint32_t)); j++)
-      {
-        //kprint("Copy params\n");
-        *i = (uint32_t) * params;
-        //kprint("Param copied\n");
-        //i += ARG_SIZE * sizeof(char);
-        i++;
-        (uint32_t *) params++;
-      }
-      //kprint((char *) pcb_get_sp(p));
+      l = arg_len(slot);
+      *d++ = l;
+      strcpyn(slot, d, l);
+      d += l + 1;
     }
-    else
-      pcb_set_sp(p, (uint32_t) i);
+  }
 
-    //kprint("copy arg done\n");
+  proc_start(p, b, kget_count());
 
-    /*
-     * Set the parameters of the function
-     * The begin of the parameters are pointed by the stack pointer
-     */
-    if (params != NULL)
-    {
-      p->registers.a_reg[0] = argc + 1;
-      p->registers.a_reg[1] = (uint32_t) pcb_get_sp(p);
-    }
-    else
-    {
-      p->registers.a_reg[0] = 0;
-      p->registers.a_reg[1] = 0;
-    }
+  return pid;
+}
 
-    /*
-     * Set the state
-     */
+/*
+ * Check a block of arguments: its first argument, the name, must be in it
+ */
+static bool
+args_ok(argblock * args)
+{
+  return args->argc >= 1 && args->size >= ARG_HEADER + 2
+    && args->size <= ARG_BLOCK
+    && ARG_HEADER + (uint8_t) args->data[0] + 2 <= args->size
+    && args->data[(uint8_t) args->data[0] + 1] == '\0';
+}
 
-    pcb_set_state(p, READY);
+/*
+ * Copy a block of arguments by words to the top of the stack of p
+ */
+static argblock *
+args_copy(pcb * p, argblock * args)
+{
+  uint32_t       *s, *d, i, words;
 
-    /*
-     * Set the last error
-     */
-    pcb_set_error(p, OMGROXX);
+  words = (args->size + 3) / 4;
+  s = (uint32_t *) args;
+  d = pcb_get_stack(p) + pcb_get_stack_size(p) - words;
 
-    /*
-     * The pcb is no more empty
-     */
-    pcb_set_empty(p, FALSE);
+  for (i = 0; i < words; i++)
+    d[i] = s[i];
 
-    /*
-     * Now we can add the pcb to the ready list
-     */
-    //if (pls_add(&plsready, p) == OUTOMEM)
-    //{
-      /*
-       * Adding fail, don't forget to dealloc every allocated stuff
-       */
-     // deallocate_stack(pcb_get_pid(p));
-      //pcb_reset(p);
-      //return OUTOMEM;
-    //}
-	 pls_add(&plsready, p);
+  return (argblock *) d;
+}
 
-    /*
-     * Everything goes well, we add one to the pcb_counter
-     */
-    pcb_counter++;
+/**
+ * \private
+ * create a process from a packed block of arguments, its first argument is
+ * the name of the program. The block is copied by words to the top of the
+ * stack.
+ */
+int32_t
+create_proc_args(uint32_t prio, argblock * args)
+{
+  int32_t         pid;
+  pcb            *p;
 
-  }
-  else
-  {
-    return OUTOMEM;
-  }
+  if (args == NULL)
+    return NULLPTR;
+
+  if (!args_ok(args))
+    return INVARG;
+
+  pid = proc_new(args->data + 1, prio, &p);
+
+  if (pid < 0)
+    return pid;
 
-  //kdebug_println("Create process out");
+  proc_start(p, args_copy(p, args), kget_count());
 
   return pid;
 }
 
 /**
  * \private
- * Search all the list to found a pcb.
+ * create s->n processes of the same program. The program is searched once,
+ * then the pcbs, the pids and the stacks are taken in the same loop. They
+ * all become ready at the same date.
  */
-pcb            *
-search_all_list(uint32_t pid)
+int32_t
+create_proc_many(spawninfo * s)
 {
+  uint32_t        i, now;
+  int32_t         pid;
+  argblock       *args;
+  prgm           *prg;
   pcb            *p;
 
-  p = pls_search_pid(&plsready, pid);
+  if (s == NULL || s->name == NULL || s->pids == NULL
+      || (s->nargs > 0 && s->args == NULL))
+    return NULLPTR;
+
+  if (s->prio > MAX_PRI || s->prio < MIN_PRI || s->n < 0 || s->nargs < 0)
+    return INVARG;
 
-  if (p != NULL)
-    return p;
+  for (i = 0; i < s->nargs; i++)
+    if (!args_ok(&s->args[i]))
+      return INVARG;
 
-  p = pls_search_pid(&plsrunning, pid);
+  prg = search_prgm(s->name);
 
-  if (p != NULL)
-    return p;
+  if (prg == NULL)
+    return INVARG;
 
-  p = pls_search_pid(&plswaiting, pid);
+  now = kget_count();
 
-  if (p != NULL)
-    return p;
+  for (i = 0; i < s->n; i++)
+  {
+    pid = proc_alloc(prg, s->prio, &p);
 
-  p = pls_search_pid(&plsterminate, pid);
+    /*
+     * No more pcb or stack: the next pid is the error
+     */
+    if (pid < 0)
+    {
+      s->pids[i] = pid;
+      break;
+    }
 
-  if (p != NULL)
-    return p;
+    args = NULL;
 
-  return NULL;
+    if (s->nargs > 0)
+      args = args_copy(p, &s->args[i % s->nargs]);
+
+    proc_start(p, args, now);
+    s->pids[i] = pid;
+  }
+
+  return i;
+}
+
+/**
+ * \private
+ * Search all the list to found a pcb.
+ */
+pcb            *
+search_all_list(uint32_t pid)
+{
+  return pls_find_pid(pid);
 }
 
 /**
@@ -346,10 +428,12 @@ rm_p(pcb * p)
   if (p == NULL)
     return NULLPTR;
 
-	deallocate_stack(pcb_get_pid(p));
+	deallocate_stack(p);
+	pcb_rm_child(p);
 	//pcb_reset(p);
 	//pcb_set_empty(p, TRUE);
 	pls_delete_pcb(p);
+	dealloc_pcb(p);
 
   pcb_counter--;
 
@@ -374,6 +458,7 @@ chg_ppri(uint32_t pid, uint32_t pri)
     return NOTFOUND;
 
   pcb_set_pri(p, pri);
+  sched_update_pri(p);
 
   return OMGROXX;
 }
@@ -385,7 +470,7 @@ chg_ppri(uint32_t pid, uint32_t pri)
 uint32_t
 get_pinfo(uint32_t pid, pcbinfo * pi)
 {
-  pcb            *p;
+  pcb            *p, *c;
   uint32_t        i;
 
   p = search_all_list(pid);
@@ -397,8 +482,18 @@ get_pinfo(uint32_t pid, pcbinfo * pi)
   strcpy(p->name, pi->name);
   pi->pri = p->pri;
 
-  for (i = 0; i < MAXPCB; i++)
-    pi->supervised[i] = pcb_get_supervised(p)[i];
+  pi->nb_supervised = 0;
+
+  for (c = pcb_get_child(p); c != NULL; c = pcb_get_sibling(c))
+  {
+    if (pi->nb_supervised < PINFO_SUPERVISED)
+      pi->supervised[pi->nb_supervised] = pcb_get_pid(c);
+
+    pi->nb_supervised++;
+  }
+
+  for (i = pi->nb_supervised; i < PINFO_SUPERVISED; i++)
+    pi->supervised[i] = -1;
 
   pi->supervisor = pcb_get_supervisor(p);
   pi->state = pcb_get_state(p);
@@ -406,6 +501,15 @@ get_pinfo(uint32_t pid, pcbinfo * pi)
   pi->waitfor = pcb_get_waitfor(p);
   pi->error = pcb_get_error(p);
   pi->empty = pcb_get_empty(p);
+  pi->epri = pcb_get_epri(p);
+  kstat_pinfo(p, pi);
+
+  pi->stack_size = pcb_get_stack_size(p) * sizeof(uint32_t);
+  pi->stack_peak = 0;
+
+  if (pcb_get_stack(p) != NULL)
+    pi->stack_peak = kstack_peak(pcb_get_stack(p), pcb_get_stack_size(p))
+      * sizeof(uint32_t);
 
   return OMGROXX;
 }
@@ -427,11 +531,24 @@ get_all_pid(uint32_t * tab)
   }
 */
   pcb            *p;
-  uint32_t        i;
+  uint32_t        i, j;
 
-  p = plsready.start;
   i = 0;
 
+  for (j = 0; j < RQ_LEVELS; j++)
+  {
+    p = rqready.level[j].start;
+
+    while (p != NULL)
+    {
+      tab[i] = pcb_get_pid(p);
+      p = pcb_get_next(p);
+      i++;
+    }
+  }
+
+  p = plsrunning.start;
+
   while (p != NULL)
   {
     tab[i] = pcb_get_pid(p);
@@ -439,7 +556,7 @@ get_all_pid(uint32_t * tab)
     i++;
   }
 
-  p = plsrunning.start;
+  p = plswaiting.start;
 
   while (p != NULL)
   {
@@ -448,7 +565,7 @@ get_all_pid(uint32_t * tab)
     i++;
   }
 
-  p = plswaiting.start;
+  p = plssleeping.start;
 
   while (p != NULL)
   {
@@ -469,6 +586,51 @@ get_all_pid(uint32_t * tab)
   return pcb_counter;
 }
 
+/**
+ * \private
+ * Fill an array of psinfo with all the processes. The allocated pcbs are
+ * the clear bits of pmem_free, one word of the bitmap at a time. count is
+ * read once, all the times are taken at the same date.
+ */
+int32_t
+get_all_psinfo(psinfo * tab, uint32_t max)
+{
+  uint32_t        i, j, used, n = 0;
+  uint32_t        now = kget_count();
+  pcb            *p;
+
+  if (tab == NULL)
+    return NULLPTR;
+
+  for (i = 0; i < PMEM_WORDS && n < max; i++)
+  {
+    used = ~pmem_free[i];
+
+    /*
+     * The bits after the last pcb are never free
+     */
+    if (i == PMEM_WORDS - 1 && MAXPCB % 32 != 0)
+      used &= (1u << (MAXPCB % 32)) - 1;
+
+    while (used != 0 && n < max)
+    {
+      j = ffs32(used);
+      used &= ~(1u << j);
+      p = &pmem[i * 32 + j];
+
+      tab[n].pid = pcb_get_pid(p);
+      strcpyn(pcb_get_name(p), tab[n].name, PS_NAME - 1);
+      tab[n].state = pcb_get_state(p);
+      tab[n].pri = pcb_get_pri(p);
+      tab[n].epri = pcb_get_epri(p);
+      tab[n].nb_msg = pcb_get_messages(p)->length;
+      kstat_psinfo(p, &tab[n], now);
+      n++;
+    }
+  }
+
+  return n;
+}
 
 /**
  * \private
@@ -486,10 +648,12 @@ add_psupervised(pcb * p, uint32_t pid)
   if ((supervised = search_all_list(pid)) == NULL)
     return INVARG;
 
-  if (supervised->supervisor != -1)
+  if (pcb_get_parent(supervised) != NULL)
     return INVARG;
 
-  return pcb_set_supervised(p, pid);
+  pcb_add_child(p, supervised);
+
+  return OMGROXX;
 }
 
 /**
@@ -499,10 +663,15 @@ add_psupervised(pcb * p, uint32_t pid)
 uint32_t
 rm_psupervised(pcb * p, uint32_t pid)
 {
+  pcb            *supervised;
+
   if (p == NULL)
     return NULLPTR;
 
-  pcb_rm_supervised(p, pid);
+  supervised = search_all_list(pid);
+
+  if (supervised != NULL && pcb_get_parent(supervised) == p)
+    pcb_rm_child(supervised);
 
   return OMGROXX;
 }
@@ -526,9 +695,13 @@ go_to_sleep(uint32_t time)
     return FAILNOOB;
   }
 
-  pcb_set_state(p, SLEEPING);
-  pcb_set_sleep(p, time * timer_msec);
-  pls_move_pcb(p, &plswaiting);
+  /*
+   * The date is compared with count on their difference, avoid overflow
+   */
+  if (time > TIMER_MAX_DELTA / timer_msec)
+    time = TIMER_MAX_DELTA / timer_msec;
+
+  sleep_add(p, ktimer_date(time * timer_msec));
 
   schedule();
 
@@ -582,6 +755,12 @@ kblock_pcb(pcb * p, int32_t state)
   if (p == NULL)
     return FAILNOOB;
 
+  /*
+   * Waiting for the uart: it is an interactive one
+   */
+  if (state == WAITING_IO || state == DOING_IO)
+    sched_boost(p);
+
   pcb_set_state(p, state);
   pls_move_pcb(p, &plswaiting);
 
@@ -591,6 +770,38 @@ kblock_pcb(pcb * p, int32_t state)
   return OMGROXX;
 }
 
+/*
+ * Take the return value of a terminated process, and remove it
+ */
+static int32_t
+kreap(pcb * p, int32_t * status)
+{
+  int32_t         pid = pcb_get_pid(p);
+
+  if (status != NULL)
+    *status = pcb_get_ret(p);
+
+  rm_p(p);
+
+  return pid;
+}
+
+/*
+ * The current process waits: what for is in waitfor, the return value of
+ * the process it gets will be written in *status
+ */
+static void
+kwait(uint32_t waitfor, int32_t * status, int32_t * pids, uint32_t n)
+{
+  pcb            *p = get_current_pcb();
+
+  pcb_set_state(p, WAITING_PCB);
+  pcb_set_waitfor(p, waitfor);
+  pcb_set_wstatus(p, status);
+  pcb_set_wset(p, pids, n);
+  pls_move_pcb(p, &plswaiting);
+}
+
 /**
  * @private
  * @brief Set the currently used pcb to wait for an other pcb to terminate
@@ -621,24 +832,175 @@ waitfor(uint32_t pid, int32_t * status)
 
   if (pcb_get_head(p) == &plsterminate)
   {
-    *status = pcb_get_ret(p);
-    pcb_rm_supervised(get_current_pcb(), pid);
-    rm_p(p);
+    kreap(p, status);
     //kdebug_println("Waitfor: good out");
     return OMGROXX;
   }
 
-  pcb_set_state(get_current_pcb(), WAITING_PCB);
-  pcb_set_waitfor(get_current_pcb(), pid);
-  pls_move_pcb(get_current_pcb(), &plswaiting);
+  kwait(pid, status, NULL, 0);
+
+  /*
+   * p must not make us wait because of its priority
+   */
+  sched_depend(get_current_pcb(), p);
 
   //kdebug_println("Waitfor: call the scheduler");
   schedule();
 
+  /*
+   * If p is a child, kterminate sets our v0 to OMGROXX when it exits
+   */
   //kdebug_println("Waitfor: wait out");
   return FAILNOOB;
 }
 
+/**
+ * @private
+ * @brief Wait for any child, or for one of a set of children, to terminate
+ *
+ * A child already terminated is taken at once. Otherwise the process waits
+ * with WAITING_PCB, and the first child of the set to terminate gives it
+ * its pid and its return value (see kterminate): it comes back from the
+ * syscall with them, without calling it again.
+ */
+int32_t
+waitany(int32_t * pids, uint32_t n, int32_t * status)
+{
+  pcb            *me = get_current_pcb();
+  pcb            *p;
+  bool            found = FALSE;
+  uint32_t        i;
+
+  if (pids == NULL)
+  {
+    for (p = pcb_get_child(me); p != NULL; p = pcb_get_sibling(p))
+    {
+      if (pcb_get_state(p) == OMG_ZOMBIE)
+        return kreap(p, status);
+
+      found = TRUE;
+    }
+  }
+  else
+  {
+    if (n > MAXPCB)
+      return INVARG;
+
+    for (i = 0; i < n; i++)
+    {
+      p = search_all_list(pids[i]);
+
+      if (p == NULL || pcb_get_parent(p) != me)
+        continue;
+
+      if (pcb_get_state(p) == OMG_ZOMBIE)
+        return kreap(p, status);
+
+      found = TRUE;
+    }
+  }
+
+  if (!found)
+    return NOTFOUND;
+
+  kwait(pids == NULL ? WAIT_ANY : WAIT_SET, status, pids, n);
+  schedule();
+
+  return FAILNOOB;
+}
+
+/*
+ * The parent of p waits for it: give it the return value of p. The parent
+ * comes back from its syscall with it, so p can be removed. Return TRUE if
+ * the parent took p.
+ */
+static bool
+kwait_give(pcb * p)
+{
+  pcb            *s = pcb_get_parent(p);
+  uint32_t        w, i;
+  int32_t         res = pcb_get_pid(p);
+
+  if (s == NULL || pcb_get_state(s) != WAITING_PCB)
+    return FALSE;
+
+  w = pcb_get_waitfor(s);
+
+  if (w == pcb_get_pid(p))
+    res = OMGROXX;
+  else if (w == (uint32_t) WAIT_SET)
+  {
+    for (i = 0; i < pcb_get_wset_size(s); i++)
+      if (pcb_get_wset(s)[i] == res)
+        break;
+
+    if (i == pcb_get_wset_size(s))
+      return FALSE;
+  }
+  else if (w != (uint32_t) WAIT_ANY)
+    return FALSE;
+
+  if (pcb_get_wstatus(s) != NULL)
+    *pcb_get_wstatus(s) = pcb_get_ret(p);
+
+  pcb_set_v0(s, res);
+  kwakeup_pcb(s);
+
+  return TRUE;
+}
+
+/*
+ * Terminate a process: it becomes a zombie until its parent takes its
+ * return value. If the parent already waits for it, it takes it now.
+ */
+static void
+kterminate(pcb * p, int32_t ret)
+{
+  pcb            *s;
+
+  pcb_set_ret(p, ret);
+  pcb_set_state(p, OMG_ZOMBIE);
+  pls_move_pcb(p, &plsterminate);
+
+  /*
+   * Give back the priority lent, and the borrowed one. Its clients do not
+   * get a reply.
+   */
+  sched_undepend(p);
+  call_orphan(pcb_get_pid(p));
+  sched_orphan(p);
+
+  /*
+   * Its message buffers, and the ones in its mailbox, go back to the pool
+   */
+  kbuf_release(pcb_get_pid(p));
+
+  /*
+   * Init adopt all the supervised process
+   */
+  s = search_all_list(0);
+
+  if (s == NULL)
+  {
+    /*
+     * Ultra fatal error ! Init not here Oo
+     */
+    kprintln
+      ("OMG! No more init process Oo Computer will explode in 5..4..3...");
+    while (1);
+  }
+
+  pcb_adopt(s, p);
+
+  /*
+   * Now we can warn the supervisor (if it's not the kernel). p can be the
+   * current process: its pcb and its stack are not used again before the
+   * next schedule, and nothing is allocated before.
+   */
+  if (kwait_give(p))
+    rm_p(p);
+}
+
 /**
  * @private
  * @brief Kill the current process
@@ -671,58 +1033,38 @@ kkill(uint32_t pid)
 int32_t
 kkill_pcb(pcb * p)
 {
-pcb            *s, *tmp;
-  uint32_t        i;
-
+  if (p == NULL || pcb_get_state(p) == OMG_ZOMBIE)
+    return NOTFOUND;
 
-  pcb_set_ret(p, KILLED);
-  pcb_set_state(p, OMG_ZOMBIE);
-  pls_move_pcb(p, &plsterminate);
+  kterminate(p, KILLED);
 
- /*
-   * Now we can warn the supervisor
-   * (if it's not the kernel)
+  /*
+   * A process killing itself does not run again
    */
-  if (pcb_get_supervisor(p) != -1)
-  {
-    s = search_all_list(pcb_get_supervisor(p));
+  if (p == get_current_pcb())
+    schedule();
 
-    /*
-     * Hey, the supervisor is waiting for me !
-     * Wake it up!
-     */
-    if (pcb_get_state(s) == WAITING_PCB
-        && pcb_get_waitfor(s) == pcb_get_pid(p))
-    {
-      kwakeup_pcb(s);
-    }
-  }
+  return OMGROXX;
+}
 
-  /*
-   * Init adopt all the supervised process
-   */
-  s = search_all_list(0);
+/**
+ * @private
+ * @brief Kill a process that overflowed its stack
+ */
+bool
+kcheck_stack(pcb * p)
+{
+  char            c[12];
 
-  if (s == NULL)
-  {
-    /*
-     * Ultra fatal error ! Init not here Oo
-     */
-    kprintln
-      ("OMG! No more init process Oo Computer will explode in 5..4..3...");
-    while (1);
-  }
+  if (pcb_get_stack(p) == NULL || kstack_ok(pcb_get_stack(p)))
+    return FALSE;
 
-  for (i = 0; i < MAXPCB; i++)
-  {
-    pcb_set_supervised(s, pcb_get_supervised(p)[i]);
-    tmp = search_all_list(pcb_get_supervised(p)[i]);
+  kprint("Stack overflow: process ");
+  kprintln(itos(pcb_get_pid(p), c));
 
-    if (tmp != NULL)
-      pcb_set_supervisor(p, 0);
-  }
+  kterminate(p, STACKOVF);
 
-  return OMGROXX;
+  return TRUE;
 }
 
 /**
@@ -731,7 +1073,7 @@ pcb            *s, *tmp;
  *
  * The process caling exit is moved to the terminated list and is return value
  * is set in the apropriate register. The process get the state OMG_ZOMBIE.
- * If the supervisor wait for the process, we wake it up.
+ * If the supervisor wait for the process, it gets the return value at once.
  * If the process have some supervised child, init will adopt all of them.
  *
  * @param the returned value to set
@@ -739,58 +1081,7 @@ pcb            *s, *tmp;
 void
 kexit(int32_t return_value)
 {
-  pcb            *p, *s, *tmp;
-  uint32_t        i;
-
-  //char buf[3];
-  p = get_current_pcb();
-
-  pcb_set_ret(p, return_value);
-  pcb_set_state(p, OMG_ZOMBIE);
-  pls_move_pcb(p, &plsterminate);
-
-  /*
-   * Now we can warn the supervisor
-   * (if it's not the kernel)
-   */
-  if (pcb_get_supervisor(p) != -1)
-  {
-    s = search_all_list(pcb_get_supervisor(p));
-
-    /*
-     * Hey, the supervisor is waiting for me !
-     * Wake it up!
-     */
-    if (pcb_get_state(s) == WAITING_PCB
-        && pcb_get_waitfor(s) == pcb_get_pid(p))
-    {
-      kwakeup_pcb(s);
-    }
-  }
-
-  /*
-   * Init adopt all the supervised process
-   */
-  s = search_all_list(0);
-
-  if (s == NULL)
-  {
-    /*
-     * Ultra fatal error ! Init not here Oo
-     */
-    kprintln
-      ("OMG! No more init process Oo Computer will explode in 5..4..3...");
-    while (1);
-  }
-
-  for (i = 0; i < MAXPCB; i++)
-  {
-    pcb_set_supervised(s, pcb_get_supervised(p)[i]);
-    tmp = search_all_list(pcb_get_supervised(p)[i]);
-
-    if (tmp != NULL)
-      pcb_set_supervisor(p, 0);
-  }
+  kterminate(get_current_pcb(), return_value);
 
   /*
    * Reschedule
@@ -809,8 +1100,10 @@ kwakeup_pcb(pcb * p)
   if (p == NULL)
     return;
 
+  sched_undepend(p);
   pcb_set_state(p, READY);
-  pls_move_pcb(p, &plsready);
+  kstat_ready(p, kget_count());
+  rq_add(&rqready, p);
 
   return;
 }
@@ -846,6 +1139,22 @@ init_mem()
 
   for (i = 0; i < MAXPCB; i++)
     pcb_reset(&pmem[i]);
+
+  for (i = 0; i < PMEM_WORDS; i++)
+    pmem_free[i] = 0xFFFFFFFF;
+
+  /*
+   * The bits after the last pcb are never free
+   */
+  if (MAXPCB % 32 != 0)
+    pmem_free[PMEM_WORDS - 1] = (1u << (MAXPCB % 32)) - 1;
+
+  /*
+   * No process, no message buffer owned
+   */
+  kbuf_reset();
+
+  pcb_counter = 0;
 }
 
 /*
@@ -853,125 +1162,122 @@ init_mem()
  */
 
 /**
- * @brief Return the next avaible pid, or an error code
+ * @brief Return the next pid of a pcb of pmem, or an error code
  */
 int32_t
-get_next_pid()
+get_next_pid(pcb * p)
 {
-  int             init = next_pid;
-  while (search_all_list(next_pid) != NULL)
-  {
-    next_pid++;
-    if (next_pid == init)
-      return OUTOPID;
-  }
-  return next_pid;
+  uint32_t        i = p - pmem;
+
+  if (i >= MAXPCB)
+    return OUTOPID;
+
+  /*
+   * The pids stay positive. 0 is init's one, it never comes back.
+   */
+  if (pid_gen[i] > (0x7FFFFFFF - i) / MAXPCB)
+    pid_gen[i] = 1;
+
+  return pid_gen[i]++ * MAXPCB + i;
 }
 
 /**
  * @brief Return a pointer to a stack. The pointer is set to point at the bottom of the stack
  * since the stack grow from the bottom.
- * We need the pid to mark the stack as used by this pid
+ * The stack is taken from the buddy allocator (see kstack.h) and recorded
+ * in the pcb. size is the one of the program, 0 for the default one.
  */
 uint32_t       *
-allocate_stack(uint32_t pid)
+allocate_stack(pcb * p, uint32_t size)
 {
-  uint32_t        i;
+  uint32_t       *s;
 
-  i = 0;
-  while (used_stack[i] != -1 && i < MAXPCB)
-    i++;
+  size = kstack_size(size);
+  s = kstack_alloc(size);
 
-  if (i >= MAXPCB )
-	  return NULL;
-
-  if (used_stack[i] == -1)
-  {
-    used_stack[i] = pid;
-    return &(stack[(i + 1) * SIZE_STACK]);
-  }
+  if (s == NULL)
+    return NULL;
 
-  return NULL;
+  kstack_fill(s, size);
+  pcb_set_stack(p, s, size);
+  return s + size;
 }
 
 /**
- * @brief Dealloc a stack, in our case consist to change used_stack[pid] to -1
+ * @brief Dealloc the stack of a pcb
  */
 int32_t
-deallocate_stack(uint32_t pid)
+deallocate_stack(pcb * p)
 {
-  uint32_t        i;
+  int32_t         e;
 
-  i = 0;
-  while (used_stack[i] != pid && i < MAXPCB)
-    i++;
-
-  if ( i >= MAXPCB)
-	  return NOTFOUND;
+  if (pcb_get_stack(p) == NULL)
+    return NOTFOUND;
 
-  if (used_stack[i] == pid)
-  {
-    used_stack[i] = -1;
-    return OMGROXX;
-  }
+  e = kstack_free(pcb_get_stack(p), pcb_get_stack_size(p));
+  pcb_set_stack(p, NULL, 0);
 
-  return NOTFOUND;
+  return e;
 }
 
 /**
  * \private
- * @brief reset to -1 all the element of used_stack
+ * @brief Make all the stacks free
  */
 void
 reset_used_stack()
 {
-  uint32_t        i;
-
-  for (i = 0; i < MAXPCB; i++)
-    used_stack[i] = -1;
+  kstack_reset();
 }
 
 /**
- * @brief reset the next_pid to 0
+ * @brief reset the generations of the pids to 0
  */
 void
 reset_next_pid()
 {
-  next_pid = 0;
-}
+  uint32_t        i;
 
-/**
- * @brief return a pointer to the used stack
- */
-int32_t        *
-get_used_stack()
-{
-  return used_stack;
+  for (i = 0; i < MAXPCB; i++)
+    pid_gen[i] = 0;
 }
 
 /**
  * @brief Allocate a space for a pcb, and reset the pcb
  *
- * This function will look for a empty space in the static pcb, reset it
- * and return a pointer to this space.
+ * This function takes the first free pcb of the bitmap, so the pcb are
+ * still used in the order of pmem.
  *
  * @return a pointer to a pcb
  */
 pcb            *
 alloc_pcb()
 {
-  uint32_t        i;
+  uint32_t        i, j;
 
-  i = 0;
-  while (pcb_get_empty(&pmem[i]) == FALSE && i < MAXPCB)
-    i++;
+  for (i = 0; i < PMEM_WORDS; i++)
+  {
+    if (pmem_free[i] != 0)
+    {
+      j = ffs32(pmem_free[i]);
+      pmem_free[i] &= ~(1u << j);
+      return &pmem[i * 32 + j];
+    }
+  }
 
-  if (i >= MAXPCB)
-    return NULL;
+  return NULL;
+}
 
-  //kprint("Alloc\n");
+/**
+ * @brief Give back a pcb to the bitmap of the free pcb
+ */
+void
+dealloc_pcb(pcb * p)
+{
+  uint32_t        i = p - pmem;
 
-  return &pmem[i];
+  if (i < MAXPCB)
+    pmem_free[i / 32] |= 1u << (i % 32);
 }
 
 /*
@@ -27,13 +27,36 @@
  * @brief Create a new process and add it to the ready list
  * @param the name of the process
  * @param the priority of the process
- * @param the parameter to pass to the process
+ * @param the number of parameters, the name excluded
+ * @param the parameter to pass to the process: argc + 1 strings of ARG_SIZE
+ * chars, the first one is the name. They are packed in an argblock.
  * @return the pid of the process or a negative error code
  * (INVARG, OUTOMEM, FAILNOOB)
  */
 uint32_t        create_proc(char *name, uint32_t prio, uint32_t argc,
                             char **params);
 
+/**
+ * @brief Create a new process from a block of arguments and add it to the
+ * ready list
+ * @param prio the priority of the process
+ * @param args the arguments, the first one is the name of the program. The
+ * block is copied to the stack of the process.
+ * @return the pid of the process or a negative error code
+ * (NULLPTR, INVARG, OUTOMEM)
+ */
+int32_t         create_proc_args(uint32_t prio, argblock * args);
+
+/**
+ * @brief Create several processes of the same program and add them to the
+ * ready list
+ * @param s the program, the priority, the number of processes, their
+ * arguments and the array of their pids (see spawninfo)
+ * @return the number of processes created, or a negative error code
+ * (NULLPTR, INVARG). If it is less than s->n, the next pid is the error.
+ */
+int32_t         create_proc_many(spawninfo * s);
+
 /**
  * @brief Return the pcb currently running
  * @return A pointer to the pcb
@@ -47,7 +70,8 @@ pcb            *get_current_pcb();
 void            set_current_pcb(pcb * p);
 
 /**
- * @brief Search for a pid in all the list of the kernel
+ * @brief Search for a pid in all the list of the kernel, in constant time
+ * (see pls_find_pid)
  * @param the pid
  * @return the pcb
  */
@@ -86,6 +110,16 @@ uint32_t        get_pinfo(uint32_t pid, pcbinfo * pi);
  */
 uint32_t        get_all_pid(uint32_t * tab);
 
+/**
+ * \brief Fill an array of psinfo with all the processes, in one pass over the
+ * allocated pcbs
+ *
+ * \param tab the array of psinfo
+ * \param max the size of the array
+ * \return the number of psinfo filled, or NULLPTR
+ */
+int32_t         get_all_psinfo(psinfo * tab, uint32_t max);
+
 /**
  * \brief add a pid to the supervise list of a process
  *
@@ -163,6 +197,23 @@ int32_t         kblock_pcb(pcb * p, int32_t state);
  */
 int32_t         waitfor(uint32_t pid, int32_t * status);
 
+/**
+ * @brief Wait for any child, or for one of a set of children, to terminate
+ *
+ * A child already terminated is removed at once. Otherwise the current
+ * process waits with the state WAITING_PCB and waitfor WAIT_ANY or
+ * WAIT_SET, and schedule is called. The first child of the set that
+ * terminates writes its return value in *status and the pid in the v0
+ * register of the waiting process, then it is removed.
+ *
+ * @param pids the pids to wait for, NULL for all the children
+ * @param n the number of pids
+ * @param status where to write the return value of the child, can be NULL
+ * @return the pid of the child, NOTFOUND if no pid is a child, INVARG if n
+ * is more than MAXPCB, FAILNOOB if the process waits
+ */
+int32_t         waitany(int32_t * pids, uint32_t n, int32_t * status);
+
 /**
  * @brief Kill the current process
  *
@@ -187,11 +238,24 @@ int32_t         kkill(uint32_t pid);
  */
 int32_t         kkill_pcb(pcb * p);
 
+/**
+ * @brief Kill a process that overflowed its stack
+ *
+ * The canary at the low end of the stack is checked (see kstack.h). If it
+ * was overwritten, the process is killed with the STACKOVF return code.
+ *
+ * @param p the pcb to check
+ * @return TRUE if the process was killed
+ */
+bool            kcheck_stack(pcb * p);
+
 /**
  * @brief exit the current process and set the return value in the register
  *
  * The process caling exit is moved to the terminated list and is return value
  * is set in the apropriate register. The process get the state OMG_ZOMBIE.
+ * If the supervisor waits for it, it gets the return value at once and the
+ * process is removed.
  *
  * @param the returned value to set
  */
@@ -219,30 +283,31 @@ void            kwakeup(uint32_t pid);
 void            init_mem();
 
 /**
- * @brief Allocate a space for a pcb, and reset the pcb
+ * @brief Allocate a space for a pcb
  *
- * This function will look for a empty space in the static pcb, reset it
- * and return a pointer to this space.
+ * This function takes the first free pcb in a bitmap of the static pcb and
+ * marks it used. The caller resets it.
  *
- * @return a pointer to a pcb
+ * @return a pointer to a pcb, NULL if they are all used
  */
 pcb            *alloc_pcb();
 
 /**
- * @brief Deallocte a pcb.
+ * @brief Deallocte a pcb: it is free again in the bitmap.
  * @param p the pcb to dealloc
  * @return void
  */
 void            dealloc_pcb(pcb * p);
 
  /**
- * \brief reset the next_pid variable to 0
+ * \brief reset the generations of the pids, the first pids are again 0,
+ * 1, 2...
  * @return void
  */
 void            reset_next_pid();
 
 /**
- * @brief reset to -1 all the element of used_stack
+ * @brief Make all the stacks free (see kstack.h)
  * @return void
  */
 void            reset_used_stack();
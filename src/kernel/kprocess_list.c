@@ -13,6 +13,11 @@
  */
 void            pls_reset_all_pcb(pcb * p);
 
+/**
+ * @brief Index of the pcb in the lists, by pid
+ */
+static pcb     *pls_index[PID_SLOTS];
+
 /*
  * Public functions definition
  */
@@ -35,7 +40,11 @@ pls_reset(pls * ls)
    * Delete the element of the list
    */
   ls->start = NULL;
+  ls->end = NULL;
   ls->length = 0;
+
+  if (ls->map != NULL)
+    *ls->map &= ~ls->bit;
 }
 
 /**
@@ -58,114 +67,143 @@ pls_add(pls * ls, pcb * p)
     return NULLPTR;
 
   /*
-   * Found the position of the element
+   * Empty list, or the pcb is the less prioritary one: it goes at the end
+   * without walking the list
    */
-  if (ls->start == NULL)
-  {
-    /*
-     * Nothing in the list, we add the pcb at the begin of the list
-     */
-    ls->start = p;
-    pcb_set_next(p, NULL);
-    pcb_set_prev(p, NULL);
-  }
+  if (ls->end == NULL || pcb_get_pri(ls->end) >= pcb_get_pri(p))
+    return pls_insert(ls, p, NULL);
 
   /*
-   * We search the good position in the list
+   * We search the good position in the list : before the first pcb
+   * with a lower priority
    */
+  next = ls->start;
+
+  while (pcb_get_pri(next) >= pcb_get_pri(p))
+    next = pcb_get_next(next);
+
+  return pls_insert(ls, p, next);
+}
+
+/**
+ * @private
+ * @brief Insert an element in the list, just before an other one.
+ */
+int32_t
+pls_insert(pls * ls, pcb * p, pcb * next)
+{
+  pcb            *prev;
+
+  if (!ls || !p)
+    return NULLPTR;
+
+  prev = (next == NULL) ? ls->end : pcb_get_prev(next);
+
+  pcb_set_prev(p, prev);
+  pcb_set_next(p, next);
+
+  if (prev == NULL)
+    ls->start = p;
+  else
+    pcb_set_next(prev, p);
+
+  if (next == NULL)
+    ls->end = p;
   else
-  {
-    next = ls->start;
-
-    /*
-     * Looking for the position
-     */
-    while (pcb_get_pri(next) >= pcb_get_pri(p) && pcb_get_next(next) != NULL)
-    {
-      next = pcb_get_next(next);
-    }
-
-    /*
-     * are we at the end of the list ?
-     */
-    if (pcb_get_pri(next) < pcb_get_pri(p))
-    {
-      //kprintln("I should pass here");
-      /*
-       * no
-       */
-      if (ls->start == next)
-      {
-        /*
-         * The pcb is added in the front of the list
-         */
-        ls->start = p;
-        pcb_set_prev(p, NULL);
-        pcb_set_prev(next, p);
-        pcb_set_next(p, next);
-      }
-      else
-      {
-        pcb_set_next(pcb_get_prev(next), p);
-        pcb_set_prev(p, pcb_get_prev(next));
-        pcb_set_next(p, next);
-        pcb_set_prev(next, p);
-      }
-    }
-
-    else
-    {
-      /*
-       * Yes
-       */
-      pcb_set_next(next, p);
-      pcb_set_next(p, NULL);
-      pcb_set_prev(p, next);
-    }
-
-
-  }
+    pcb_set_prev(next, p);
 
   pcb_set_head(p, ls);
   ls->length++;
 
+  pls_index[pcb_get_pid(p) % PID_SLOTS] = p;
+
+  if (ls->map != NULL)
+    *ls->map |= ls->bit;
+
   return OMGROXX;
 }
 
 /**
  * @private
- * @brief Delete a pcb from a list. (Reset it to his default value)
+ * @brief Remove a pcb from the list where it is, without resetting it.
  */
-uint32_t
-pls_delete_pcb(pcb * p)
+int32_t
+pls_remove(pcb * p)
 {
+  pls            *ls;
 
   if (!p)
     return NULLPTR;
 
+  ls = pcb_get_head(p);
+
+  /*
+   * Not in a list, nothing to do
+   */
+  if (ls == NULL)
+    return OMGROXX;
+
   /*
    * If the pcb is on the front of the list
    */
   if (pcb_get_prev(p) == NULL)
-  {
-    pcb_get_head(p)->start = pcb_get_next(p);
-    if (pcb_get_next(p) != NULL)
-      pcb_set_prev(pcb_get_next(p), NULL);
-  }
+    ls->start = pcb_get_next(p);
+  else
+    pcb_set_next(pcb_get_prev(p), pcb_get_next(p));
+
   /*
-   * otherwise
+   * If the pcb is at the end of the list
    */
+  if (pcb_get_next(p) == NULL)
+    ls->end = pcb_get_prev(p);
   else
-  {
-    pcb_set_next(pcb_get_prev(p), pcb_get_next(p));
-    if (pcb_get_next(p) != NULL)
-      pcb_set_prev(pcb_get_next(p), pcb_get_prev(p));
-  }
+    pcb_set_prev(pcb_get_next(p), pcb_get_prev(p));
 
   /*
    * Shorting the list
    */
-  pcb_get_head(p)->length--;
+  ls->length--;
+
+  if (ls->length == 0 && ls->map != NULL)
+    *ls->map &= ~ls->bit;
+
+  pcb_set_head(p, NULL);
+  pcb_set_next(p, NULL);
+  pcb_set_prev(p, NULL);
+
+  return OMGROXX;
+}
+
+/**
+ * @private
+ * @brief Attach the list to a bit of a bitmap word.
+ */
+void
+pls_set_map(pls * ls, uint32_t * map, uint32_t bit)
+{
+  ls->map = map;
+  ls->bit = bit;
+
+  if (map == NULL)
+    return;
+
+  if (ls->length != 0)
+    *map |= bit;
+  else
+    *map &= ~bit;
+}
+
+/**
+ * @private
+ * @brief Delete a pcb from a list. (Reset it to his default value)
+ */
+uint32_t
+pls_delete_pcb(pcb * p)
+{
+  if (!p)
+    return NULLPTR;
+
+  pls_remove(p);
 
   /*
    * Reset the pcb
@@ -186,32 +224,9 @@ pls_move_pcb(pcb * p, pls * dest)
     return NULLPTR;
 
   /*
-   * First we recreate the source list
+   * First we remove it from the source list
    */
-
-  /*
-   * If the pcb is on the front of the list
-   */
-  if (pcb_get_prev(p) == NULL)
-  {
-    pcb_get_head(p)->start = pcb_get_next(p);
-    if (pcb_get_next(p) != NULL)
-      pcb_set_prev(pcb_get_next(p), NULL);
-  }
-  /*
-   * otherwise
-   */
-  else
-  {
-    pcb_set_next(pcb_get_prev(p), pcb_get_next(p));
-    if (pcb_get_next(p) != NULL)
-      pcb_set_prev(pcb_get_next(p), pcb_get_prev(p));
-  }
-
-  /*
-   * Shorting the list
-   */
-  pcb_get_head(p)->length--;
+  pls_remove(p);
 
   /*
    * Now we add the pcb to his new list
@@ -246,6 +261,21 @@ pls_search_pid(pls * ls, uint32_t pid)
     return NULL;
 }
 
+/**
+ * @private
+ * @brief Find a pid in all the lists, in constant time
+ */
+pcb            *
+pls_find_pid(uint32_t pid)
+{
+  pcb            *p = pls_index[pid % PID_SLOTS];
+
+  if (p == NULL || pcb_get_head(p) == NULL || pcb_get_pid(p) != pid)
+    return NULL;
+
+  return p;
+}
+
 /*
  * Private functions definition
  */
@@ -13,6 +13,12 @@
 #include <stdlib.h>
 #include "kpcb.h"
 
+/**
+ * @brief Number of entries of the pid index. Two pcb in the lists at the
+ * same time must not have the same pid modulo PID_SLOTS (see get_next_pid).
+ */
+#define PID_SLOTS MAXPCB
+
 /**
  * \struct pls
  * \brief List of processes.
@@ -21,7 +27,10 @@
 typedef struct _PLS
 {
   pcb            *start;        /*!< First pcb of the list */
+  pcb            *end;          /*!< Last pcb of the list */
   uint32_t        length;       /*!< number of processes currently in the list */
+  uint32_t       *map;          /*!< Bitmap word flagged while the list is not empty, or NULL */
+  uint32_t        bit;          /*!< Bit of map owned by the list */
 } pls;
 
 /**
@@ -44,6 +53,39 @@ void            pls_reset(pls * ls);
  */
 int32_t         pls_add(pls * ls, pcb * p);
 
+/**
+ * \brief Insert an element in the list, just before an other one.
+ *
+ * The priority order is not checked, the caller choose the position.
+ * The pcb must not be in any list.
+ *
+ * \param ls the list where we add an element
+ * \param p a pointer to the pcb to insert
+ * \param next the pcb of ls that will follow p, NULL to add p at the end
+ * \return OMGROXX if everything goes well.
+ */
+int32_t         pls_insert(pls * ls, pcb * p, pcb * next);
+
+/**
+ * \brief Remove a pcb from the list where it is, without resetting it.
+ *
+ * \param p a pointer to the pcb to remove
+ * \return OMGROXX if everything goes well.
+ */
+int32_t         pls_remove(pcb * p);
+
+/**
+ * \brief Attach the list to a bit of a bitmap word.
+ *
+ * The bit is set as long as the list is not empty. Used by the run queue to
+ * find the non empty levels without walking them.
+ *
+ * \param ls the list
+ * \param map the bitmap word
+ * \param bit the mask of the bit owned by the list
+ */
+void            pls_set_map(pls * ls, uint32_t * map, uint32_t bit);
+
 /**
  * \brief Delete a pcb from a list. (Reset it to his default value)
  *
@@ -73,4 +115,16 @@ int32_t         pls_move_pcb(pcb * p, pls * dest);
  */
 pcb            *pls_search_pid(pls * ls, uint32_t pid);
 
+/**
+ * @brief Find a pid in all the lists, in constant time
+ *
+ * Each pcb inserted in a list is recorded in an index, at its pid modulo
+ * PID_SLOTS. The entry is only checked at the lookup: the pcb must still be
+ * in a list with the same pid.
+ *
+ * @param the pid to found
+ * @return the pcb, NULL if no pcb in a list has this pid
+ */
+pcb            *pls_find_pid(uint32_t pid);
+
 #endif
@@ -6,6 +6,7 @@
 #include <string.h>
 #include "kprogram.h"
 #include "kernel.h"
+#include "kstack.h"
 #include "../user/coquille.h"
 #include "../user/fibonacci.h"
 #include "../user/philosopher.h"
@@ -17,12 +18,13 @@
 #include "../user/ring.h"
 #include "../user/supervisor.h"
 #include "../user/arg_test.h"
+#include "../user/stress.h"
 
 /*
  * Define
  */
 
-#define NUM_PROG 18
+#define NUM_PROG 19
 
 /*
  * Global variable
@@ -38,6 +40,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "init",
    (uint32_t) init,
+   0,
    "Initialize the system."},
 
   /*
@@ -46,6 +49,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "scroll",
    (uint32_t) scroll,
+   STACK_MIN * 2,
    "Scroll a string on the malta LCD."},
 
   /*
@@ -54,6 +58,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "chg_prio",
    (uint32_t) chg_prio,
+   STACK_MIN * 2,
    "Change the priority of a process."},
 
   /*
@@ -62,6 +67,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "ps",
    (uint32_t) ps,
+   STACK_MIN * 2,
    "Give information about all the processes runing."},
   /*
    * The kill program
@@ -69,6 +75,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "tuer",
    (uint32_t) tuer,
+   STACK_MIN * 2,
    "Kill a process."},
 
   /*
@@ -77,6 +84,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "malta",
    (uint32_t) malta,
+   STACK_MIN * 2,
    "Print a string on the malta LCD."},
 
   /*
@@ -85,6 +93,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "help",
    (uint32_t) help,
+   STACK_MIN * 2,
    "List all the commands available."},
 
   /*
@@ -93,6 +102,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "proc_info",
    (uint32_t) proc_info,
+   STACK_MIN * 2,
    "Return information about a process."},
 
   /*
@@ -101,6 +111,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "coquille",
    (uint32_t) coquille,
+   0,
    "The shell program"},
 
   /*
@@ -109,6 +120,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "fibonacci",
    (uint32_t) fibonacci,
+   STACK_MIN * 2,
    "Fibonacci computation program"},
 
   /*
@@ -117,6 +129,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "increment",
    (uint32_t) increment,
+   STACK_MIN * 2,
    "Increment a number to a limit"},
 
   /*
@@ -125,6 +138,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "ring",
    (uint32_t) ring,
+   STACK_MIN * 4,
    "The ring program"},
 
   /*
@@ -133,6 +147,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "philos",
    (uint32_t) dining_philosopher,
+   0,
    "The philosopher problem"},
 
   /*
@@ -141,6 +156,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "philosopher",
    (uint32_t) philosopher,
+   STACK_MIN * 2,
    "The philosopher processes in the dining_philospher problem"},
 
   /*
@@ -149,6 +165,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "waiter",
    (uint32_t) waiter,
+   STACK_MIN * 2,
    "The waiter process in the dining_philosopher problem"},
 
   /*
@@ -157,6 +174,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "supervisor",
    (uint32_t) supervisor,
+   STACK_MIN * 4,
    "The supervisor demonstration"},
 
   /*
@@ -165,6 +183,7 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "quit",
    (uint32_t) quit_main,
+   STACK_MIN,
    "Quit, a test for quitting a program"},
 
   /*
@@ -173,7 +192,17 @@ static prgm     prgm_ls[NUM_PROG] = {
   {
    "arg_test",
    (uint32_t) arg_test_main,
-   ""}
+   STACK_MIN * 2,
+   ""},
+
+  /*
+   * Stress, as many processes as the system can hold
+   */
+  {
+   "stress",
+   (uint32_t) stress,
+   STACK_MIN * 2,
+   "Create the most processes possible, print the cost"}
 };
 
 /**
@@ -15,13 +15,14 @@
 /**
  * @brief A program structure
  *
- * This structure contains the name, the adress, and a description
- * of a program.
+ * This structure contains the name, the adress, the size of the stack and a
+ * description of a program.
  */
 typedef struct
 {
   char            name[20];     /*!< name of the program */
   uint32_t        address;      /*!< adresse of the main function */
+  uint32_t        stack;        /*!< size of the stack in words, 0 for STACK_DEFAULT (see kstack.h) */
   char            desc[1024];   /*!< A description of the program */
 } prgm;
 
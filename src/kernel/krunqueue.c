@@ -0,0 +1,224 @@
+/**
+ * \file krunqueue.c
+ * \brief Run queue of the ready processes (definitions)
+ */
+
+#include <errno.h>
+#include <bitops.h>
+#include "kernel.h"
+#include "krunqueue.h"
+
+#if SCHED_POLICY == SCHED_STRIDE
+/*
+ * Move up the entry i of the heap to its place
+ */
+static void
+rq_heap_up(runqueue * rq, uint32_t i)
+{
+  rq_entry        e = rq->heap[i];
+
+  while (i > 0 && PASS_BEFORE(e.pass, rq->heap[(i - 1) / 2].pass))
+  {
+    rq->heap[i] = rq->heap[(i - 1) / 2];
+    i = (i - 1) / 2;
+  }
+
+  rq->heap[i] = e;
+}
+
+/*
+ * Move down the entry i of the heap to its place
+ */
+static void
+rq_heap_down(runqueue * rq, uint32_t i)
+{
+  rq_entry        e = rq->heap[i];
+  uint32_t        c;
+
+  while ((c = 2 * i + 1) < rq->heap_len)
+  {
+    if (c + 1 < rq->heap_len
+        && PASS_BEFORE(rq->heap[c + 1].pass, rq->heap[c].pass))
+      c++;
+
+    if (!PASS_BEFORE(rq->heap[c].pass, e.pass))
+      break;
+
+    rq->heap[i] = rq->heap[c];
+    i = c;
+  }
+
+  rq->heap[i] = e;
+}
+
+/*
+ * Add an entry for a process of the run queue
+ */
+static void
+rq_heap_push(runqueue * rq, pcb * p)
+{
+  uint32_t        i;
+  pcb            *q;
+
+  /*
+   * Full of out of date entries: rebuild it from the levels, p is already
+   * in one of them
+   */
+  if (rq->heap_len == RQ_HEAP)
+  {
+    rq->heap_len = 0;
+
+    for (i = 0; i < RQ_LEVELS; i++)
+      for (q = rq->level[i].start; q != NULL; q = pcb_get_next(q))
+      {
+        rq->heap[rq->heap_len].p = q;
+        rq->heap[rq->heap_len].pass = pcb_get_pass(q);
+        rq_heap_up(rq, rq->heap_len++);
+      }
+
+    return;
+  }
+
+  rq->heap[rq->heap_len].p = p;
+  rq->heap[rq->heap_len].pass = pcb_get_pass(p);
+  rq_heap_up(rq, rq->heap_len++);
+}
+
+/*
+ * Remove the top entry of the heap
+ */
+static void
+rq_heap_pop(runqueue * rq)
+{
+  rq->heap[0] = rq->heap[--rq->heap_len];
+  rq_heap_down(rq, 0);
+}
+#endif
+
+/**
+ * @private
+ * @brief Reset the run queue. All the pcb inside are reset too.
+ */
+void
+rq_reset(runqueue * rq)
+{
+  uint32_t        i;
+
+  for (i = 0; i < RQ_WORDS; i++)
+    rq->map[i] = 0;
+
+  for (i = 0; i < RQ_LEVELS; i++)
+  {
+    pls_reset(&rq->level[i]);
+    pls_set_map(&rq->level[i], &rq->map[i / 32], 1u << (i % 32));
+  }
+
+#if SCHED_POLICY == SCHED_STRIDE
+  rq->heap_len = 0;
+  rq->vtime = 0;
+#endif
+}
+
+/**
+ * @private
+ * @brief Add a process at the end of the fifo of its effective priority.
+ */
+int32_t
+rq_add(runqueue * rq, pcb * p)
+{
+  int32_t         res;
+
+  if (!rq || !p)
+    return NULLPTR;
+
+  pls_remove(p);
+
+  res = pls_insert(rq_level(rq, pcb_get_epri(p)), p, NULL);
+
+#if SCHED_POLICY == SCHED_STRIDE
+  if (PASS_BEFORE(pcb_get_pass(p), rq->vtime))
+    pcb_set_pass(p, rq->vtime);
+
+  rq_heap_push(rq, p);
+#endif
+
+  return res;
+}
+
+/**
+ * @private
+ * @brief Return the first process of the highest non empty level.
+ */
+pcb            *
+rq_first(runqueue * rq)
+{
+#if SCHED_POLICY == SCHED_STRIDE
+  rq_entry       *e;
+
+  while (rq->heap_len > 0)
+  {
+    e = &rq->heap[0];
+
+    if (rq_has(rq, e->p) && e->pass == pcb_get_pass(e->p))
+    {
+      rq->vtime = e->pass;
+      return e->p;
+    }
+
+    rq_heap_pop(rq);
+  }
+#else
+  int32_t         i;
+
+  for (i = RQ_WORDS - 1; i >= 0; i--)
+    if (rq->map[i] != 0)
+      return rq->level[i * 32 + fls32(rq->map[i])].start;
+#endif
+
+  return NULL;
+}
+
+/**
+ * @private
+ * @brief Return the fifo of a priority level.
+ */
+pls            *
+rq_level(runqueue * rq, uint32_t pri)
+{
+  return &rq->level[pri - MIN_PRI];
+}
+
+/**
+ * @private
+ * @brief Return if a process is in the run queue
+ */
+bool
+rq_has(runqueue * rq, pcb * p)
+{
+  pls            *ls = pcb_get_head(p);
+
+  return (ls >= &rq->level[0] && ls < &rq->level[RQ_LEVELS]);
+}
+
+/**
+ * @private
+ * @brief Search a pid in the run queue
+ */
+pcb            *
+rq_search_pid(runqueue * rq, uint32_t pid)
+{
+  uint32_t        i;
+  pcb            *p;
+
+  for (i = 0; i < RQ_LEVELS; i++)
+  {
+    p = pls_search_pid(&rq->level[i], pid);
+
+    if (p != NULL)
+      return p;
+  }
+
+  return NULL;
+}
+
+/* end of file krunqueue.c */
@@ -0,0 +1,142 @@
+/**
+ * \file krunqueue.h
+ * \brief Run queue of the ready processes
+ *
+ * The run queue hold one fifo per priority level and a bitmap of the non
+ * empty levels. The processes are sorted by their effective priority.
+ * Adding a process, removing it and finding the most prioritary one are
+ * done in constant time, whatever the number of processes.
+ *
+ * With SCHED_POLICY == SCHED_STRIDE, the first process is instead the one
+ * with the smallest pass. A binary min-heap of the ready processes, keyed
+ * on their pass, finds it in O(log n). The processes removed from the
+ * levels are not searched in the heap: their entries are dropped when they
+ * reach the top (lazy deletion).
+ */
+
+#ifndef __KRUNQUEUE_H
+#define __KRUNQUEUE_H
+
+#include <stdlib.h>
+#include <process.h>
+#include "kprocess_list.h"
+
+/**
+ * @brief Number of levels in the run queue (one per priority)
+ */
+#define RQ_LEVELS (MAX_PRI - MIN_PRI + 1)
+
+/**
+ * @brief Number of words of the bitmap of the non empty levels
+ */
+#define RQ_WORDS ((RQ_LEVELS + 31) / 32)
+
+#ifndef SCHED_POLICY
+#error "SCHED_POLICY is not defined, include kernel.h"
+#endif
+
+#if SCHED_POLICY == SCHED_STRIDE
+/**
+ * @brief Size of the heap of the stride scheduler. It is rebuilt from the
+ * levels when it is full of removed processes.
+ */
+#define RQ_HEAP (2 * MAXPCB)
+
+/**
+ * @brief Is the pass a before the pass b ? The passes wrap, like the dates.
+ */
+#define PASS_BEFORE(a, b) ((int32_t) ((a) - (b)) < 0)
+
+/**
+ * \struct rq_entry
+ * \brief Entry of the heap of the stride scheduler.
+ *
+ * The entry is out of date if the process left the run queue or if its
+ * pass changed since.
+ */
+typedef struct
+{
+  pcb            *p;            /*!< the process */
+  uint32_t        pass;         /*!< its pass when it was added */
+} rq_entry;
+#endif
+
+/**
+ * \struct runqueue
+ * \brief Ready processes, sorted by priority.
+ *
+ * level[i] is the fifo of the ready processes of priority i + MIN_PRI. The
+ * bit i of the bitmap is set as long as level[i] is not empty, it is
+ * maintained by the list functions (see pls_set_map).
+ */
+typedef struct
+{
+  pls             level[RQ_LEVELS];     /*!< One fifo per priority */
+  uint32_t        map[RQ_WORDS];        /*!< Bitmap of the non empty levels */
+#if SCHED_POLICY == SCHED_STRIDE
+  rq_entry        heap[RQ_HEAP];        /*!< Min-heap on the pass */
+  uint32_t        heap_len;     /*!< Number of entries of the heap */
+  uint32_t        vtime;        /*!< Pass of the last first process */
+#endif
+} runqueue;
+
+/**
+ * @brief Reset the run queue. All the pcb inside are reset too.
+ * @param rq the run queue
+ */
+void            rq_reset(runqueue * rq);
+
+/**
+ * @brief Add a process at the end of the fifo of its effective priority.
+ *
+ * The process is removed from the list where it was before, if any.
+ * Calling it on a process already in the run queue move it at the end of
+ * its level (or in its new level if its priority changed).
+ *
+ * With SCHED_STRIDE, a process whose pass is behind the virtual time of the
+ * run queue catches up with it: sleeping does not save cpu time.
+ *
+ * @param rq the run queue
+ * @param p the pcb to add
+ * @return OMGROXX if everything goes well.
+ */
+int32_t         rq_add(runqueue * rq, pcb * p);
+
+/**
+ * @brief Return the first process of the highest non empty level, or the
+ * one with the smallest pass with SCHED_STRIDE.
+ *
+ * The process is not removed from the run queue.
+ *
+ * @param rq the run queue
+ * @return the pcb, or NULL if the run queue is empty
+ */
+pcb            *rq_first(runqueue * rq);
+
+/**
+ * @brief Return the fifo of a priority level.
+ * @param rq the run queue
+ * @param pri the priority
+ * @return the list of the ready processes with this priority
+ */
+pls            *rq_level(runqueue * rq, uint32_t pri);
+
+/**
+ * @brief Return if a process is in the run queue
+ * @param rq the run queue
+ * @param p the pcb
+ * @return TRUE if p is in one of the levels of rq
+ */
+bool            rq_has(runqueue * rq, pcb * p);
+
+/**
+ * @brief Search a pid in the run queue
+ * @param rq the run queue
+ * @param pid the pid to found
+ * @return the pcb, NULL if not found
+ */
+pcb            *rq_search_pid(runqueue * rq, uint32_t pid);
+
+#endif
+
+/* end of file krunqueue.h */
@@ -13,6 +13,94 @@
 #include "kinout.h"
 #include "kscheduler.h"
 #include "kprocess.h"
+#include "ktimer.h"
+#include "kstat.h"
+#include "kstack.h"
+
+#if SCHED_POLICY == SCHED_MLFQ
+/**
+ * @brief Time slice of each level, in ms
+ */
+static const uint32_t mlfq_quanta[MLFQ_LEVELS] = MLFQ_QUANTA;
+#endif
+
+#if SCHED_POLICY == SCHED_STRIDE
+/**
+ * @brief Date of the last choice of the scheduler
+ */
+static uint32_t run_start;
+
+/*
+ * The process p ran for a time: it goes forward in virtual time, in
+ * 1/64 of its stride
+ */
+static void
+sched_charge(pcb * p, uint32_t time)
+{
+  uint32_t        stride = STRIDE_ONE / (pcb_get_epri(p) - MIN_PRI + 1);
+
+  if (time >= QUANTUM)
+    time = 64;
+  else
+    time = time * 64 / QUANTUM;
+
+  pcb_set_pass(p, pcb_get_pass(p) + stride * time / 64);
+}
+#endif
+
+/*
+ * The canary of the process leaving the cpu is checked on each switch,
+ * whether it is preempted, blocked or asleep. A zombie is not checked: it
+ * does not run again anyway.
+ */
+static bool
+sched_stack_ok(pcb * prev)
+{
+  return prev == NULL || pcb_get_state(prev) == OMG_ZOMBIE
+    || pcb_get_stack(prev) == NULL || kstack_ok(pcb_get_stack(prev));
+}
+
+/*
+ * Give the cpu to p, NULL to none
+ */
+static void
+sched_switch(pcb * prev, pcb * p, bool preempted, uint32_t now)
+{
+  /*
+   * Keep the statistics, if the cpu changes of hands
+   */
+  if (p != prev)
+    kstat_switch(prev, p, preempted, now);
+
+  /*
+   * Nothing to do
+   */
+  if (p == NULL)
+  {
+    /*
+     * Set the current pcb to null
+     */
+    set_current_pcb(NULL);
+
+    /*
+     * Set the error pointer to the kernel error
+     */
+    p_error = &kerror;
+
+    //kprintln("Scheduler: Nothing to do");
+    return;
+  }
+
+  pcb_set_state(p, RUNNING);
+  pls_move_pcb(p, &plsrunning);
+  set_current_pcb(p);
+  ktimer_slice_start(sched_quantum(p));
+
+  /*
+   * Now we set the error pointer
+   */
+  p_error = (uint32_t *) & (p->error);
+}
 
 /**
  * Schedule the process
@@ -22,137 +110,346 @@
 void
 schedule()
 {
-  uint32_t        pri;
-  pcb            *p;
-  //char c;
+  pcb            *p, *prev;
+  bool            preempted;
+  uint32_t        now;
 
   //kdebug_println("Scheduler in");
 
   /*
-   * Real first
-   * If running and waiting are empty, we dont have anything to do
+   * The current process can still run ? It goes back at the end of its
+   * level in the run queue, behind the other processes of the same
+   * priority (Round Robin)
+   */
+  prev = get_current_pcb();
+
+  /*
+   * A process that overflowed its stack does not run again
+   */
+  if (!sched_stack_ok(prev))
+    kcheck_stack(prev);
+
+  preempted = (prev != NULL && pcb_get_head(prev) == &plsrunning);
+  now = kget_count();
+
+  kstat_cpu(prev == NULL, now);
+
+#if SCHED_POLICY == SCHED_STRIDE
+  /*
+   * Charge the time it ran, before it is sorted again
    */
-  if (plsrunning.start == NULL && plsready.start == NULL)
+  if (prev != NULL)
+    sched_charge(prev, now - run_start);
+
+  run_start = now;
+#endif
+
+  if (preempted)
   {
-    p_error = &kerror;
-    set_current_pcb(NULL);
-    //kprintln("Scheduler: Nothing to do");
-    return;
+    pcb_set_state(prev, READY);
+    rq_add(&rqready, prev);
   }
 
   /*
-   * First we take the priority of the element of running
-   * In running everybody have the same priority
+   * The next one is the first of the highest non empty level
+   */
+  p = rq_first(&rqready);
+
+  sched_switch(prev, p, preempted, now);
+
+  //kdebug_println("Scheduler out");
+}
+
+/**
+ * Give the cpu straight to a process woken by the running one
+ *
+ * \private
+ */
+void
+sched_handoff(pcb * p)
+{
+  pcb            *prev = get_current_pcb();
+  uint32_t        now = kget_count();
+
+  sched_undepend(p);
+  kstat_ready(p, now);
+
+  /*
+   * The running process still runs, a ready one comes first, or the
+   * running one overflowed its stack: the scheduler chooses, once p is
+   * ready and out of reach of the clean up of prev
    */
-  if (plsrunning.start != NULL)
+  if (prev == NULL || pcb_get_head(prev) == &plsrunning
+      || !sched_stack_ok(prev) || sched_preempt(p, rq_first(&rqready)))
   {
-    pri = pcb_get_pri(plsrunning.start);
+    pcb_set_state(p, READY);
+    rq_add(&rqready, p);
+    schedule();
+    return;
   }
+
+  kstat_cpu(FALSE, now);
+
+#if SCHED_POLICY == SCHED_STRIDE
+  sched_charge(prev, now - run_start);
+  run_start = now;
+#endif
+
+  sched_switch(prev, p, FALSE, now);
+}
+
+/**
+ * Compute again the effective priority of a process
+ *
+ * \private
+ */
+void
+sched_update_pri(pcb * p)
+{
+  uint32_t        epri = pcb_get_pri(p);
+
+#if SCHED_POLICY == SCHED_MLFQ
+  /*
+   * Each level costs MLFQ_STEP of priority
+   */
+  if (epri >= MIN_PRI + pcb_get_level(p) * MLFQ_STEP)
+    epri -= pcb_get_level(p) * MLFQ_STEP;
   else
-  {
-    //kprintln("Pass here1");
-    pri = 0;
-  }
+    epri = MIN_PRI;
+#endif
 
   /*
-   * Is the first element of the ready list more prioritary ?
-   * The list are ordered by default, so we just have to check
-   * the first to know
-   * If so we need to empty the running list
+   * The priority lent by the processes waiting for this one
    */
-  if (plsready.start != NULL && pri < pcb_get_pri(plsready.start))
-  {
-    //kprintln("Pass here2");
-    p = plsrunning.start;
+  if (pcb_get_ipri(p) > epri)
+    epri = pcb_get_ipri(p);
 
-    while (p != NULL)
-    {
-      pcb_set_state(p, READY);
-      pls_move_pcb(p, &plsready);
-      p = plsrunning.start;
-    }
+  pcb_set_epri(p, epri);
 
-    pri = pcb_get_pri(plsready.start);
-  }
+  /*
+   * A ready process has to change of level in the run queue
+   */
+  if (rq_has(&rqready, p) && pcb_get_head(p) != rq_level(&rqready, epri))
+    rq_add(&rqready, p);
+}
+
+/**
+ * Return the time slice of a process
+ *
+ * \private
+ */
+uint32_t
+sched_quantum(pcb * p)
+{
+#if SCHED_POLICY == SCHED_MLFQ
+  return mlfq_quanta[pcb_get_level(p)] * timer_msec;
+#else
+  return QUANTUM;
+#endif
+}
+
+/**
+ * Does the end of the time slice of the running process matter ?
+ *
+ * \private
+ */
+bool
+sched_need_slice(pcb * p)
+{
+#if SCHED_POLICY == SCHED_MLFQ
+  /*
+   * The process goes down at the end of its slice, even if it is alone
+   */
+  return TRUE;
+#elif SCHED_POLICY == SCHED_STRIDE
+  /*
+   * Any ready process may have a smaller pass at the end of the slice
+   */
+  return rq_first(&rqready) != NULL;
+#else
+  /*
+   * Only if there is someone to give the hand to
+   */
+  return rq_level(&rqready, pcb_get_epri(p))->length > 0;
+#endif
+}
+
+/**
+ * Does a ready process have to take the cpu now ?
+ *
+ * \private
+ */
+bool
+sched_preempt(pcb * p, pcb * q)
+{
+  if (q == NULL)
+    return FALSE;
+
+#if SCHED_POLICY == SCHED_STRIDE
+  /*
+   * The running one keeps the cpu until the end of its slice
+   */
+  return p == NULL;
+#else
+  return p == NULL || pcb_get_epri(q) > pcb_get_epri(p);
+#endif
+}
+
+/**
+ * Reschedule at once if a ready process comes before the running one
+ *
+ * \private
+ */
+void
+sched_check_preempt()
+{
+  if (sched_preempt(get_current_pcb(), rq_first(&rqready)))
+    schedule();
+}
 
+/**
+ * The running process used its whole time slice
+ *
+ * \private
+ */
+void
+sched_expire(pcb * p)
+{
+#if SCHED_POLICY == SCHED_MLFQ
+  if (pcb_get_level(p) < MLFQ_LEVELS - 1)
+  {
+    pcb_set_level(p, pcb_get_level(p) + 1);
+    sched_update_pri(p);
+  }
+#elif SCHED_POLICY == SCHED_STRIDE
   /*
-   * Now we can add the element of the highest priority in
-   * running.
-   * Again since the list are ordered, we just have to take
-   * the first part of the element.
+   * Charge the whole slice now, the scheduler will only charge the time
+   * after
    */
-  p = plsready.start;
-  //kdebug_assert_at(pcb_get_next(p) == NULL, "schedule()", 84);
+  sched_charge(p, QUANTUM);
+  run_start = kget_count();
+#endif
+}
 
-  while (p != NULL && pcb_get_pri(p) == pri)
+/**
+ * A process blocks on an IO or a message
+ *
+ * \private
+ */
+void
+sched_boost(pcb * p)
+{
+#if SCHED_POLICY == SCHED_MLFQ
+  if (pcb_get_level(p) != 0)
   {
-    //kprintln("Pass here3");
-    pcb_set_state(p, RUNNING);
-    pls_move_pcb(p, &plsrunning);
-    p = plsready.start;
+    pcb_set_level(p, 0);
+    sched_update_pri(p);
   }
+#endif
+}
+
+/*
+ * Highest effective priority of the processes of a list waiting for q
+ */
+static uint32_t
+sched_lent(pls * ls, pcb * q, uint32_t ipri)
+{
+  pcb            *p;
+
+  for (p = ls->start; p != NULL; p = pcb_get_next(p))
+    if (pcb_get_blocker(p) == q && pcb_get_epri(p) > ipri)
+      ipri = pcb_get_epri(p);
+
+  return ipri;
+}
+
+/**
+ * A process starts to wait for another one
+ *
+ * \private
+ */
+void
+sched_depend(pcb * p, pcb * q)
+{
+  uint32_t        i, epri;
+
+  if (p == NULL || q == NULL || p == q)
+    return;
+
+  pcb_set_blocker(p, q);
 
   /*
-   * Is the plsrunning list empty ?
+   * Follow the chain while the priority rises. The number of steps is
+   * bounded in case of a loop (two processes waiting for each other).
    */
-  if (plsrunning.start == NULL)
+  epri = pcb_get_epri(p);
+
+  for (i = 0; q != NULL && i < MAXPCB && epri > pcb_get_ipri(q); i++)
   {
-    /*
-     * Set the current pcb to null
-     */
-    set_current_pcb(NULL);
+    pcb_set_ipri(q, epri);
+    sched_update_pri(q);
 
-    /*
-     * Set the error pointer to the kernel error
-     */
-    p_error = &kerror;
+    epri = pcb_get_epri(q);
+    q = pcb_get_blocker(q);
   }
+}
+
+/**
+ * A process stops to wait
+ *
+ * \private
+ */
+void
+sched_undepend(pcb * p)
+{
+  uint32_t        i, ipri, epri;
+  pcb            *q;
+
+  if (p == NULL || pcb_get_blocker(p) == NULL)
+    return;
+
+  q = pcb_get_blocker(p);
+  pcb_set_blocker(p, NULL);
 
   /*
-   * Nop not at all !
+   * The waiting processes are not running: the priority lent to q is
+   * computed again from the waiting and sleeping lists. It goes on
+   * along the chain while it changes.
    */
-  else
+  for (i = 0; q != NULL && i < MAXPCB; i++)
   {
-    //kprintln("Pass here4");
-    /*
-     * The current pcb is in the list of running process ?
-     */
-    if (get_current_pcb() != NULL
-        && pcb_get_head(get_current_pcb()) == &plsrunning)
-    {
-
-      p = get_current_pcb();
-
-      if (pcb_get_next(p) != NULL)
-        /*
-         * We set the current pcb to the next element of the list
-         */
-        set_current_pcb(pcb_get_next(p));
-
-      /*
-       * hey ! p is null :/
-       * DON'T PANIC ! Just take the first element in the running list ;)
-       */
-      else
-        set_current_pcb(plsrunning.start);
-    }
+    ipri = sched_lent(&plswaiting, q, MIN_PRI);
+    ipri = sched_lent(&plssleeping, q, ipri);
 
-    /*
-     * Nop not in the list!
-     * So just take the first of the runnig list :)
-     */
-    else
-      set_current_pcb(plsrunning.start);
+    epri = pcb_get_epri(q);
+    pcb_set_ipri(q, ipri);
+    sched_update_pri(q);
 
-    /*
-     * Now we set the error pointer
-     */
-    p_error = &(get_current_pcb()->error);
+    if (pcb_get_epri(q) == epri)
+      return;
+
+    q = pcb_get_blocker(q);
   }
+}
 
-  /*
-   * Ok we are done ! (maybe)
-   */
+/**
+ * A process terminates
+ *
+ * \private
+ */
+void
+sched_orphan(pcb * q)
+{
+  pcb            *p;
 
-  //kdebug_println("Scheduler out");
+  for (p = plswaiting.start; p != NULL; p = pcb_get_next(p))
+    if (pcb_get_blocker(p) == q)
+      pcb_set_blocker(p, NULL);
+
+  for (p = plssleeping.start; p != NULL; p = pcb_get_next(p))
+    if (pcb_get_blocker(p) == q)
+      pcb_set_blocker(p, NULL);
+
+  pcb_set_ipri(q, MIN_PRI);
+  sched_update_pri(q);
 }
@@ -10,12 +10,137 @@
 #ifndef __KSCHEDULER_H
 #define __KSCHEDULER_H
 
+#include "kpcb.h"
+
+/**
+ * @brief Number of levels of the multi-level feedback queue
+ */
+#define MLFQ_LEVELS 4
+
+/**
+ * @brief Priority lost by a process each time it goes down of one level
+ */
+#ifndef MLFQ_STEP
+#define MLFQ_STEP 8
+#endif
+
+/**
+ * @brief Time slice of each level, in ms
+ */
+#ifndef MLFQ_QUANTA
+#define MLFQ_QUANTA {10, 20, 40, 80}
+#endif
+
+/**
+ * @brief Pass of a process with one ticket for a whole time slice, with
+ * SCHED_STRIDE. A process has epri - MIN_PRI + 1 tickets.
+ */
+#define STRIDE_ONE (1 << 16)
+
 /**
  * @brief Schedule the process
  *
- * The process are scheduling using high priority first, and Round Robin when
- * the process have the same priority.
+ * The process are scheduling using high effective priority first, and Round
+ * Robin when the process have the same effective priority. The ready
+ * processes are taken from the run queue (see krunqueue.h), plsrunning only
+ * hold the current one.
+ *
+ * With SCHED_POLICY == SCHED_MLFQ, a process that uses its whole time slice
+ * goes down of one level, loosing MLFQ_STEP of effective priority, but gets
+ * a longer slice. A process that blocks on an IO or a message goes back to
+ * the first level. Otherwise the effective priority is the priority and the
+ * time slice is QUANTUM.
+ *
+ * With SCHED_POLICY == SCHED_STRIDE, every ready process gets the cpu in
+ * proportion of its tickets, given by its effective priority. A process
+ * running for a time slice goes forward of its stride (STRIDE_ONE divided
+ * by its tickets) in virtual time, its pass, and the process with the
+ * smallest pass runs next. A process waking up does not preempt the running
+ * one.
+ *
+ * A process waiting for another one (waitfor, or a message from a given pid)
+ * lends it its effective priority until it stops waiting, so a less
+ * prioritary process does not make it wait longer (priority inheritance).
  */
 void            schedule();
 
+/**
+ * @brief Give the cpu straight to a process woken by the running one, which
+ * just blocked, without looking at the run queue. The scheduler runs as
+ * usual if the running process did not block or if a ready process has to
+ * take the cpu before p.
+ * @param p the pcb to run, blocked, out of the run queue
+ */
+void            sched_handoff(pcb * p);
+
+/**
+ * @brief Compute again the effective priority of a process, after a change
+ * of its priority, its level or its inherited priority. A ready process
+ * changes of level in the run queue.
+ * @param p the pcb
+ */
+void            sched_update_pri(pcb * p);
+
+/**
+ * @brief Return the time slice of a process
+ * @param p the pcb
+ * @return the time slice, in count unit
+ */
+uint32_t        sched_quantum(pcb * p);
+
+/**
+ * @brief Does the end of the time slice of the running process matter ?
+ * @param p the running pcb
+ * @return TRUE if the timer has to interrupt at the end of the slice
+ */
+bool            sched_need_slice(pcb * p);
+
+/**
+ * @brief Does a ready process have to take the cpu now ?
+ * @param p the running pcb, or NULL
+ * @param q the first ready pcb, or NULL
+ * @return TRUE if the scheduler has to be called now
+ */
+bool            sched_preempt(pcb * p, pcb * q);
+
+/**
+ * @brief Give the cpu now to a ready process that has to take it from the
+ * running one: a process just woken up, or any one once the running process
+ * gave back a lent priority. The timer is only the fallback.
+ */
+void            sched_check_preempt();
+
+/**
+ * @brief The running process used its whole time slice
+ * @param p the running pcb
+ */
+void            sched_expire(pcb * p);
+
+/**
+ * @brief A process blocks on an IO or a message
+ * @param p the pcb
+ */
+void            sched_boost(pcb * p);
+
+/**
+ * @brief A process starts to wait for another one, it lends it its
+ * effective priority, and to the one it waits for, and so on.
+ * @param p the waiting pcb
+ * @param q the pcb p waits for
+ */
+void            sched_depend(pcb * p, pcb * q);
+
+/**
+ * @brief A process stops to wait, the priority it lent is given back
+ * @param p the pcb which does not wait any more
+ */
+void            sched_undepend(pcb * p);
+
+/**
+ * @brief A process terminates, the ones waiting for it do not lend it their
+ * priority any more
+ * @param q the terminated pcb
+ */
+void            sched_orphan(pcb * q);
+
 #endif
@@ -12,70 +12,84 @@
 #include "kinout.h"
 #include "kscheduler.h"
 #include "ksleep.h"
+#include "ktimer.h"
+#include "kstat.h"
+#include "kmsg.h"
 
 /**
- * Decrement sleeping time of the process in plswaiting.
+ * Put a process to sleep until a date.
  *
- * If a process as to be waking up, he is moved to the plsready list.
+ * plssleeping is sorted by date, the search begins by the end since a new
+ * sleep usually ends after the ones already there.
  * \private
  */
 void
-process_sleep()
+sleep_add(pcb * p, uint32_t date)
 {
-  pcb            *p, *last;
+  pcb            *q;
 
-  /*
-   * First : maybe we don't have anything to do ?
-   */
-  if (plswaiting.length == 0)
-    return;
+  pcb_set_state(p, SLEEPING);
+  pcb_set_sleep(p, date);
+
+  pls_remove(p);
+
+  q = plssleeping.end;
+
+  while (q != NULL && !TIMER_REACHED(pcb_get_sleep(q), date))
+    q = pcb_get_prev(q);
 
   /*
-   * Ok the list contains stuff
+   * Insert after q, which is the last one to wake up before p
    */
-  last = NULL;
-  p = plswaiting.start;
+  if (q == NULL)
+    pls_insert(&plssleeping, p, plssleeping.start);
+  else
+    pls_insert(&plssleeping, p, pcb_get_next(q));
+}
 
-  //kprintln("Time to remove time");
+/**
+ * Wake up the sleeping process whose date is passed.
+ *
+ * They are the first ones of plssleeping: only them are looked at.
+ * \private
+ */
+void
+process_sleep(uint32_t now)
+{
+  pcb            *p;
 
-  while (p != NULL)
+  while ((p = plssleeping.start) != NULL
+         && TIMER_REACHED(pcb_get_sleep(p), now))
   {
     /*
-     * Is the pcb sleeping ?
+     * Oh did I wake you up ?
      */
-    if (pcb_get_state(p) == SLEEPING)
-    {
-      /*
-       * Can we remove a QUANTUM from is sleeping time ?
-       */
-      if (pcb_get_sleep(p) >= QUANTUM)
-        pcb_set_sleep(p, (pcb_get_sleep(p) - QUANTUM));
-
-      else
-      {
-        /*
-         * Oh did I wake you up ?
-         */
-        pcb_set_sleep(p, 0);
-        pcb_set_state(p, READY);
-        pls_move_pcb(p, &plsready);
-
-        /*
-         * set it to the "real" next one but don't update last !
-         */
-        if (last == NULL)
-          p = plswaiting.start;
-        else
-          p = last;
-
-        continue;
-      }
-    }
+    pcb_set_sleep(p, 0);
 
     /*
-     * These are not the droids you are looking for
+     * A receiver whose timeout ends does not wait for the message any more
      */
-    last = p;
-    p = pcb_get_next(last);
+    if (pcb_get_state(p) == WAITING_MSG)
+      recv_cancel(&p->messages);
+
+    sched_undepend(p);
+    pcb_set_state(p, READY);
+    kstat_ready(p, now);
+    rq_add(&rqready, p);
   }
 }
+
+/**
+ * Find the date of the first sleeping process to wake up
+ * \private
+ */
+bool
+sleep_next(uint32_t * date)
+{
+  if (plssleeping.start == NULL)
+    return FALSE;
+
+  *date = pcb_get_sleep(plssleeping.start);
+
+  return TRUE;
+}
@@ -1,16 +1,38 @@
 
 /**
- * @brief Decrement sleeping time of the process in plswaiting.
+ * @brief Wake up the sleeping process when their date is passed.
  *
- * If a process as to be waking up, he is moved to the plsready list.
+ * The sleeping processes are in plssleeping, sorted by their wake up date,
+ * so a timer interrupt only looks at the ones that have to wake up. If a
+ * process as to be waking up, he is moved to the run queue. The dates are
+ * absolute values of the count register (see ktimer.h). A process waiting
+ * for a message with a timeout is there too, with the state WAITING_MSG.
  */
 
 #ifndef __SLEEP_H
 #define __SLEEP_H
 
+#include <types.h>
+#include "kpcb.h"
+
+/**
+ * @brief Put a process to sleep. It is moved to plssleeping.
+ * @param p the pcb to put to sleep
+ * @param date the value of count when the process must wake up
+ */
+void            sleep_add(pcb * p, uint32_t date);
+
+/**
+ * @brief Wake up the sleeping processes whose date is passed
+ * @param now the current value of count
+ */
+void            process_sleep(uint32_t now);
+
 /**
- * @brief Decrease the sleep variable in the pcb. Wake up the process
+ * @brief Find the date of the first sleeping process to wake up
+ * @param date set to the date, if any
+ * @return TRUE if there is a sleeping process
  */
-void            process_sleep();
+bool            sleep_next(uint32_t * date);
 
 #endif
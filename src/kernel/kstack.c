@@ -0,0 +1,288 @@
+/**
+ * \file kstack.c
+ * \brief Buddy allocator of the process stacks
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include "kstack.h"
+
+/**
+ * @brief Number of blocks of STACK_MIN words in the region
+ */
+#define STACK_BLOCKS (STACK_WORDS / STACK_MIN)
+
+/**
+ * @brief End of a list of free blocks
+ */
+#define NIL -1
+
+/**
+ * @brief The region of the stacks
+ */
+static uint32_t stack[STACK_WORDS];
+
+/**
+ * @brief For each block of STACK_MIN words: order + 1 of the free block
+ * that begins there, 0 if no free block begins there
+ */
+static uint8_t  block_free[STACK_BLOCKS];
+
+/**
+ * @brief For each block of STACK_MIN words: order + 1 of the allocated
+ * block that begins there, 0 if no allocated block begins there
+ */
+static uint8_t  block_used[STACK_BLOCKS];
+
+/**
+ * @brief Lists of the free blocks of each order, linked by block number
+ */
+static int32_t  free_head[STACK_ORDERS];
+static int32_t  free_next[STACK_BLOCKS];
+static int32_t  free_prev[STACK_BLOCKS];
+
+/**
+ * @brief Number of free words
+ */
+static uint32_t free_words;
+
+/*
+ * Add the block b of order k to its free list
+ */
+static void
+kstack_push(int32_t b, uint32_t k)
+{
+  free_prev[b] = NIL;
+  free_next[b] = free_head[k];
+
+  if (free_head[k] != NIL)
+    free_prev[free_head[k]] = b;
+
+  free_head[k] = b;
+  block_free[b] = k + 1;
+}
+
+/*
+ * Remove the block b of order k from its free list
+ */
+static void
+kstack_unlink(int32_t b, uint32_t k)
+{
+  if (free_prev[b] != NIL)
+    free_next[free_prev[b]] = free_next[b];
+  else
+    free_head[k] = free_next[b];
+
+  if (free_next[b] != NIL)
+    free_prev[free_next[b]] = free_prev[b];
+
+  block_free[b] = 0;
+}
+
+/*
+ * Order of a block size, -1 if it is not one
+ */
+static int32_t
+kstack_order(uint32_t size)
+{
+  uint32_t        k;
+
+  for (k = 0; k < STACK_ORDERS; k++)
+    if (size == STACK_MIN << k)
+      return k;
+
+  return -1;
+}
+
+/**
+ * \private
+ * Make all the region free
+ */
+void
+kstack_reset()
+{
+  uint32_t        k;
+  int32_t         b;
+
+  for (k = 0; k < STACK_ORDERS; k++)
+    free_head[k] = NIL;
+
+  for (b = 0; b < STACK_BLOCKS; b++)
+  {
+    block_free[b] = 0;
+    block_used[b] = 0;
+  }
+
+  /*
+   * The region is made of blocks of the biggest order, pushed from the end
+   * so that the first stacks are at the beginning
+   */
+  for (b = STACK_BLOCKS - (1 << (STACK_ORDERS - 1)); b >= 0;
+       b -= 1 << (STACK_ORDERS - 1))
+    kstack_push(b, STACK_ORDERS - 1);
+
+  free_words = STACK_WORDS;
+}
+
+/**
+ * \private
+ * Size of the block given for a stack
+ */
+uint32_t
+kstack_size(uint32_t size)
+{
+  uint32_t        s = STACK_MIN;
+
+  if (size == 0)
+    size = STACK_DEFAULT;
+
+  if (size > STACK_MAX)
+    return 0;
+
+  while (s < size)
+    s <<= 1;
+
+  return s;
+}
+
+/**
+ * \private
+ * Allocate a stack: the smallest free block big enough is split until it
+ * has the wanted size.
+ */
+uint32_t       *
+kstack_alloc(uint32_t size)
+{
+  int32_t         k = kstack_order(size);
+  uint32_t        j;
+  int32_t         b;
+
+  if (k < 0)
+    return NULL;
+
+  for (j = k; j < STACK_ORDERS && free_head[j] == NIL; j++);
+
+  if (j >= STACK_ORDERS)
+    return NULL;
+
+  b = free_head[j];
+  kstack_unlink(b, j);
+
+  /*
+   * The upper halves go back to the free lists
+   */
+  while (j > k)
+  {
+    j--;
+    kstack_push(b + (1 << j), j);
+  }
+
+  block_used[b] = k + 1;
+  free_words -= size;
+
+  return &stack[b * STACK_MIN];
+}
+
+/**
+ * \private
+ * Give back a stack: it is merged with its buddy while the buddy is free.
+ */
+int32_t
+kstack_free(uint32_t * base, uint32_t size)
+{
+  int32_t         k = kstack_order(size);
+  int32_t         b, buddy;
+
+  if (k < 0 || base < stack || base >= stack + STACK_WORDS)
+    return INVARG;
+
+  b = (base - stack) / STACK_MIN;
+
+  if (block_used[b] != k + 1 || base != &stack[b * STACK_MIN])
+    return INVARG;
+
+  block_used[b] = 0;
+  free_words += size;
+
+  while (k < STACK_ORDERS - 1)
+  {
+    buddy = b ^ (1 << k);
+
+    if (block_free[buddy] != k + 1)
+      break;
+
+    kstack_unlink(buddy, k);
+
+    if (buddy < b)
+      b = buddy;
+
+    k++;
+  }
+
+  kstack_push(b, k);
+
+  return OMGROXX;
+}
+
+/**
+ * \private
+ * Fill a new stack with the pattern and the canary
+ */
+void
+kstack_fill(uint32_t * base, uint32_t size)
+{
+#if STACK_CHECK
+  uint32_t        i;
+
+  base[0] = STACK_CANARY;
+
+  for (i = 1; i < size; i++)
+    base[i] = STACK_PATTERN;
+#endif
+}
+
+/**
+ * \private
+ * Check the canary of a stack
+ */
+bool
+kstack_ok(uint32_t * base)
+{
+#if STACK_CHECK
+  return base[0] == STACK_CANARY;
+#else
+  return TRUE;
+#endif
+}
+
+/**
+ * \private
+ * Peak usage of a stack. The stack grows down from base + size, so the
+ * first word without the pattern from the bottom is the deepest one used.
+ */
+uint32_t
+kstack_peak(uint32_t * base, uint32_t size)
+{
+#if STACK_CHECK
+  uint32_t        i = 1;
+
+  while (i < size && base[i] == STACK_PATTERN)
+    i++;
+
+  return size - i;
+#else
+  return 0;
+#endif
+}
+
+/**
+ * \private
+ * Number of free words in the region
+ */
+uint32_t
+kstack_free_words()
+{
+  return free_words;
+}
+
+/* end of file kstack.c */
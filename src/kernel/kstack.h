@@ -0,0 +1,133 @@
+/**
+ * \file kstack.h
+ * \brief Buddy allocator of the process stacks
+ *
+ * The stacks are carved from a static region. A stack is a block of
+ * STACK_MIN * 2^k words, k < STACK_ORDERS. A free block is split in two
+ * buddies to give a smaller one, and two free buddies are merged back. The
+ * sizes are in words (uint32_t), like the stack pointer moves.
+ */
+
+#ifndef __KSTACK_H
+#define __KSTACK_H
+
+#include <types.h>
+#include <process.h>
+
+/**
+ * @brief Size of the smallest stack, in words
+ */
+#define STACK_MIN 512
+
+/**
+ * @brief Number of sizes of stack: from STACK_MIN to STACK_MAX
+ */
+#define STACK_ORDERS 5
+
+/**
+ * @brief Size of the biggest stack, in words
+ */
+#define STACK_MAX (STACK_MIN << (STACK_ORDERS - 1))
+
+/**
+ * @brief Size of the stack of a program that does not give one, in words
+ */
+#define STACK_DEFAULT 4096
+
+/**
+ * @brief Words of the region reserved for each pcb, in average. The
+ * programs mostly ask for less than STACK_DEFAULT, a system with a lot of
+ * pcb can reserve less, ex: make KCONFIG="-DMAXPCB=1024 -DSTACK_PER_PCB=1024"
+ */
+#ifndef STACK_PER_PCB
+#define STACK_PER_PCB STACK_DEFAULT
+#endif
+
+/**
+ * @brief Size of the region of the stacks, in words: STACK_PER_PCB for each
+ * pcb, in blocks of STACK_MAX
+ */
+#define STACK_WORDS \
+  ((MAXPCB * STACK_PER_PCB + STACK_MAX - 1) / STACK_MAX * STACK_MAX)
+
+/**
+ * @brief Fill the stacks with STACK_PATTERN, with STACK_CANARY at their low
+ * end, to measure their peak usage and catch the overflows. 0 to disable it,
+ * ex: make KCONFIG=-DSTACK_CHECK=0
+ */
+#ifndef STACK_CHECK
+#define STACK_CHECK 1
+#endif
+
+/**
+ * @brief Value of the free words of a stack
+ */
+#define STACK_PATTERN 0x57AC57AC
+
+/**
+ * @brief Value of the lowest word of a stack. A process that changes it
+ * has overflowed its stack.
+ */
+#define STACK_CANARY 0xDEADC0DE
+
+/**
+ * @brief Make all the region free
+ */
+void            kstack_reset();
+
+/**
+ * @brief Size of the block given for a stack
+ * @param size the wanted size, in words. 0 means STACK_DEFAULT.
+ * @return the size rounded up to a block size, 0 if it is more than
+ * STACK_MAX
+ */
+uint32_t        kstack_size(uint32_t size);
+
+/**
+ * @brief Allocate a stack
+ * @param size the size of the stack, as given by kstack_size
+ * @return the lowest address of the stack, NULL if there is no free block
+ * big enough or if size is not a block size
+ */
+uint32_t       *kstack_alloc(uint32_t size);
+
+/**
+ * @brief Give back a stack
+ * @param base the lowest address of the stack
+ * @param size its size
+ * @return OMGROXX, or INVARG if it is not an allocated stack
+ */
+int32_t         kstack_free(uint32_t * base, uint32_t size);
+
+/**
+ * @brief Fill a new stack with the pattern and the canary
+ * @param base the lowest address of the stack
+ * @param size its size
+ */
+void            kstack_fill(uint32_t * base, uint32_t size);
+
+/**
+ * @brief Check the canary of a stack
+ * @param base the lowest address of the stack
+ * @return FALSE if the canary was overwritten
+ */
+bool            kstack_ok(uint32_t * base);
+
+/**
+ * @brief Peak usage of a stack: the words above the last one still holding
+ * the pattern
+ * @param base the lowest address of the stack
+ * @param size its size
+ * @return the number of words used at the most, 0 without STACK_CHECK
+ */
+uint32_t        kstack_peak(uint32_t * base, uint32_t size);
+
+/**
+ * @brief Number of free words in the region
+ * @return the number of free words
+ */
+uint32_t        kstack_free_words();
+
+#endif
+
+/* end of file kstack.h */
@@ -0,0 +1,195 @@
+/**
+ * \file kstat.c
+ * \brief Scheduling statistics: per process counters and latency histogram
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include "asm.h"
+#include "bitops.h"
+#include "kstat.h"
+
+/**
+ * @brief Global statistics of the scheduler
+ */
+static schedinfo sinfo;
+
+/**
+ * @brief Date up to which the busy and idle times are counted
+ */
+static uint32_t cpu_date;
+
+/**
+ * \private
+ * Reset the global statistics
+ */
+void
+kstat_reset()
+{
+  uint32_t        i;
+
+  sinfo.switches = 0;
+
+  for (i = 0; i < LAT_BUCKETS; i++)
+    sinfo.latency[i] = 0;
+
+  sinfo.busy_time = 0;
+  sinfo.idle_time = 0;
+  cpu_date = kget_count();
+}
+
+/**
+ * \private
+ * Count the time since the last call as busy or idle
+ */
+void
+kstat_cpu(bool idle, uint32_t now)
+{
+  uint32_t        d = now - cpu_date;
+
+  if (idle)
+    sinfo.idle_time += d / timer_msec;
+  else
+    sinfo.busy_time += d / timer_msec;
+
+  /*
+   * The part of ms left is counted the next time
+   */
+  cpu_date = now - d % timer_msec;
+}
+
+/**
+ * \private
+ * A process becomes READY
+ */
+void
+kstat_ready(pcb * p, uint32_t now)
+{
+  pcb_get_stat(p)->ready_date = now;
+}
+
+/*
+ * Add a latency to the histogram
+ */
+static void
+kstat_latency(uint32_t us)
+{
+  uint32_t        i = 0;
+
+  if (us > 1)
+    i = fls32(us);
+
+  if (i >= LAT_BUCKETS)
+    i = LAT_BUCKETS - 1;
+
+  sinfo.latency[i]++;
+}
+
+/**
+ * \private
+ * The cpu goes from a process to an other one
+ */
+void
+kstat_switch(pcb * prev, pcb * next, bool preempted, uint32_t now)
+{
+  pstat          *s;
+  uint32_t        us;
+
+  if (prev != NULL)
+  {
+    s = pcb_get_stat(prev);
+    s->run_time += (now - s->run_date) / timer_usec;
+
+    if (preempted)
+    {
+      s->invol_switch++;
+      s->ready_date = now;
+    }
+    else
+      s->vol_switch++;
+  }
+
+  if (next != NULL)
+  {
+    s = pcb_get_stat(next);
+    us = (now - s->ready_date) / timer_usec;
+
+    s->wait_time += us;
+    s->run_date = now;
+    kstat_latency(us);
+  }
+
+  sinfo.switches++;
+}
+
+/*
+ * Run and wait times of a process, with its current run or wait up to now
+ */
+static void
+kstat_times(pcb * p, uint32_t * run, uint32_t * wait, uint32_t now)
+{
+  pstat          *s = pcb_get_stat(p);
+
+  *run = s->run_time;
+  *wait = s->wait_time;
+
+  if (pcb_get_state(p) == RUNNING)
+    *run += (now - s->run_date) / timer_usec;
+  else if (pcb_get_state(p) == READY)
+    *wait += (now - s->ready_date) / timer_usec;
+}
+
+/**
+ * \private
+ * Copy the statistics of a process in a pcbinfo
+ */
+void
+kstat_pinfo(pcb * p, pcbinfo * pi)
+{
+  pstat          *s = pcb_get_stat(p);
+
+  pi->ready_date = s->ready_date;
+  pi->run_date = s->run_date;
+  kstat_times(p, &pi->run_time, &pi->wait_time, kget_count());
+  pi->vol_switch = s->vol_switch;
+  pi->invol_switch = s->invol_switch;
+}
+
+/**
+ * \private
+ * Copy the statistics of a process in a psinfo
+ */
+void
+kstat_psinfo(pcb * p, psinfo * ps, uint32_t now)
+{
+  pstat          *s = pcb_get_stat(p);
+
+  kstat_times(p, &ps->run_time, &ps->wait_time, now);
+  ps->vol_switch = s->vol_switch;
+  ps->invol_switch = s->invol_switch;
+}
+
+/**
+ * \private
+ * Copy the global statistics
+ */
+int32_t
+kstat_get(schedinfo * si)
+{
+  uint32_t        i;
+
+  if (si == NULL)
+    return NULLPTR;
+
+  si->switches = sinfo.switches;
+
+  for (i = 0; i < LAT_BUCKETS; i++)
+    si->latency[i] = sinfo.latency[i];
+
+  si->busy_time = sinfo.busy_time;
+  si->idle_time = sinfo.idle_time;
+
+  return OMGROXX;
+}
+
+/* end of file kstat.c */
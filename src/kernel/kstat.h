@@ -0,0 +1,71 @@
+/**
+ * \file kstat.h
+ * \brief Scheduling statistics: per process counters and latency histogram
+ *
+ * The scheduler and the wake up functions call these functions on each
+ * READY and RUNNING transition. The dates are values of the count register,
+ * the times are in us, except the busy and idle times of the cpu in ms.
+ */
+
+#ifndef __KSTAT_H
+#define __KSTAT_H
+
+#include <types.h>
+#include <process.h>
+#include "kpcb.h"
+
+/**
+ * @brief Reset the global statistics
+ */
+void            kstat_reset();
+
+/**
+ * @brief Count the time since the last call as busy or idle. Must be called
+ * at least once per turn of count (around 64 s).
+ * @param idle TRUE if no process was running
+ * @param now the current value of count
+ */
+void            kstat_cpu(bool idle, uint32_t now);
+
+/**
+ * @brief A process becomes READY
+ * @param p the pcb
+ * @param now the current value of count
+ */
+void            kstat_ready(pcb * p, uint32_t now);
+
+/**
+ * @brief The cpu goes from a process to an other one
+ * @param prev the process that was running, or NULL
+ * @param next the process that will run, or NULL
+ * @param preempted TRUE if prev is still ready
+ * @param now the current value of count
+ */
+void            kstat_switch(pcb * prev, pcb * next, bool preempted,
+                             uint32_t now);
+
+/**
+ * @brief Copy the statistics of a process in a pcbinfo
+ * @param p the pcb
+ * @param pi the pcbinfo to fill
+ */
+void            kstat_pinfo(pcb * p, pcbinfo * pi);
+
+/**
+ * @brief Copy the statistics of a process in a psinfo
+ * @param p the pcb
+ * @param ps the psinfo to fill
+ * @param now the value of count, read once for all the processes
+ */
+void            kstat_psinfo(pcb * p, psinfo * ps, uint32_t now);
+
+/**
+ * @brief Copy the global statistics
+ * @param si the schedinfo to fill
+ * @return OMGROXX, or NULLPTR if si is NULL
+ */
+int32_t         kstat_get(schedinfo * si);
+
+#endif
+
+/* end of file kstat.h */
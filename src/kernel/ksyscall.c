@@ -20,6 +20,8 @@
 #include "debug.h"
 #include "ksleep.h"
 #include "kmsg.h"
+#include "kbuf.h"
+#include "kstat.h"
 #include "asm.h"
 
 /**
@@ -36,10 +38,20 @@ syscall_handler(registers_t * regs)
   {
   case FOURCHETTE:
     res =
-      create_proc(get_arg((char **) regs->a_reg[2], 0), regs->a_reg[0],
+      create_proc((char *) regs->a_reg[2], regs->a_reg[0],
                   regs->a_reg[1], (char **) regs->a_reg[2]);
 		if (res < 0) *p_error = res;
     break;
+  case FOURCHETTEARGS:
+    res = create_proc_args(regs->a_reg[1], (argblock *) regs->a_reg[0]);
+    if (res < 0)
+      *p_error = res;
+    break;
+  case FOURCHETTEMANY:
+    res = create_proc_many((spawninfo *) regs->a_reg[0]);
+    if (res < 0)
+      *p_error = res;
+    break;
   case PRINT:
     res = print_string((char *) regs->a_reg[0]);
     return;                     /* We save the good return value in the pcb */
@@ -64,15 +76,36 @@ syscall_handler(registers_t * regs)
   case WAIT:
     res = waitfor(regs->a_reg[0], (int32_t *) regs->a_reg[1]);
     break;
+  case WAITANY:
+    res =
+      waitany((int32_t *) regs->a_reg[0], regs->a_reg[1],
+              (int32_t *) regs->a_reg[2]);
+    break;
   case SEND:
     res =
       send_msg(pcb_get_pid(get_current_pcb()), (msg_arg *) regs->a_reg[0]);
     break;
   case RECV:
     res =
-      recv_msg(pcb_get_pid(get_current_pcb()), (msg_arg *) regs->a_reg[0]);
-    if (res == NOTFOUND)
-      go_to_sleep(((msg_arg *) regs->a_reg[0])->timeout);
+      recv_wait(pcb_get_pid(get_current_pcb()), (msg_arg *) regs->a_reg[0]);
+    break;
+  case CALL:
+    res =
+      call_msg(pcb_get_pid(get_current_pcb()), regs->a_reg[0],
+               regs->a_reg[1], (int32_t *) regs->a_reg[2]);
+    break;
+  case REPLYWAIT:
+    res =
+      reply_wait(pcb_get_pid(get_current_pcb()), regs->a_reg[0],
+                 regs->a_reg[1], (int32_t *) regs->a_reg[2]);
+    break;
+  case BUFALLOC:
+    res = (int32_t) kbuf_alloc(pcb_get_pid(get_current_pcb()));
+    if (res == 0)
+      *p_error = OUTOMEM;
+    break;
+  case BUFFREE:
+    res = kbuf_free(pcb_get_pid(get_current_pcb()), (void *) regs->a_reg[0]);
     break;
   case PERROR:
     kperror((char *) regs->a_reg[0]);
@@ -86,11 +119,17 @@ syscall_handler(registers_t * regs)
   case GETPINFO:
     res = get_pinfo(regs->a_reg[0], (pcbinfo *) regs->a_reg[1]);
     break;
+  case GETSINFO:
+    res = kstat_get((schedinfo *) regs->a_reg[0]);
+    break;
   case GETPID:
     res = pcb_get_pid(get_current_pcb());
     break;
   case GETALLPID:
-    res = get_all_pid((int *) regs->a_reg[0]);
+    res = get_all_pid((uint32_t *) regs->a_reg[0]);
+    break;
+  case GETPSINFO:
+    res = get_all_psinfo((psinfo *) regs->a_reg[0], regs->a_reg[1]);
     break;
   case CHGPPRI:
     res = chg_ppri(regs->a_reg[0], regs->a_reg[1]);
@@ -108,5 +147,11 @@ syscall_handler(registers_t * regs)
 
   // saves the return code
   regs->v_reg[0] = res;
+
+  /*
+   * The syscall may have woken up a more prioritary process, or the caller
+   * gave back a priority lent to it: it runs now, not at the next tick
+   */
+  sched_check_preempt();
   return;
 }
@@ -19,6 +19,8 @@
 enum
 {
   FOURCHETTE,                   /*!< Create a new process */
+  FOURCHETTEARGS,               /*!< Create a new process with a block of arguments */
+  FOURCHETTEMANY,               /*!< Create several processes of a program */
   PRINT,                        /*!< Print a line */
   READ,                         /*!< Print a line */
   FPRINT,                       /*!< Print a line in the specified output (malta or console) */
@@ -26,14 +28,21 @@ enum
   BLOCK,                        /*!< Block the process  */
   UNBLOCK,                      /*!< Unblock the process */
   WAIT,                         /*!< The process wait for an other process */
+  WAITANY,                      /*!< The process wait for any of its children, or a set of them */
   SEND,                         /*!< Send a message to a process */
   RECV,                         /*!< Receive a message */
+  CALL,                         /*!< Send a request to a server and wait for its reply */
+  REPLYWAIT,                    /*!< Reply to a client and wait for the next request */
+  BUFALLOC,                     /*!< Take a message buffer */
+  BUFFREE,                      /*!< Give back a message buffer */
   PERROR,                       /*!< Print the current error */
   GERROR,                       /*!< Get the current error */
   SERROR,                       /*!< Set the current error */
   GETPINFO,                     /*!< Get info of a pcb */
+  GETSINFO,                     /*!< Get the statistics of the scheduler */
   GETPID,                       /*!< Get the pid of the current process */
   GETALLPID,                    /*!< Get an array of all the pids */
+  GETPSINFO,                    /*!< Get a psinfo of all the processes */
   CHGPPRI,                      /*!< Change the priority of a process */
   KILL,                         /*!< Kill a process */
   EXIT                          /*!< Exit the current process */
@@ -0,0 +1,159 @@
+/**
+ * \file ktimer.c
+ * \brief Manage the timer interrupt and the time slices.
+ */
+
+#include <stdlib.h>
+#include "asm.h"
+#include "kernel.h"
+#include "kprocess.h"
+#include "kscheduler.h"
+#include "ksleep.h"
+#include "ktimer.h"
+#include "kstat.h"
+
+/**
+ * @brief Date of the end of the time slice of the current process
+ */
+static uint32_t slice_end;
+
+/**
+ * \private
+ * Start the timer. The count register is never reset, the dates taken
+ * before stay valid.
+ */
+void
+ktimer_init()
+{
+  kset_compare(ktimer_date(QUANTUM));
+  ktimer_slice_start(QUANTUM);
+}
+
+/**
+ * \private
+ * Return the date a delay from now
+ */
+uint32_t
+ktimer_date(uint32_t delay)
+{
+  if (delay > TIMER_MAX_DELTA)
+    delay = TIMER_MAX_DELTA;
+
+  return kget_count() + delay;
+}
+
+/**
+ * \private
+ * Start a new time slice for the current process
+ */
+void
+ktimer_slice_start(uint32_t quantum)
+{
+  slice_end = ktimer_date(quantum);
+}
+
+/**
+ * \private
+ * Handle the timer interrupt.
+ */
+void
+ktimer_interrupt()
+{
+  uint32_t        now;
+  pcb            *p;
+  bool            expired;
+
+#if TICKLESS
+  pcb            *q;
+#endif
+
+  now = kget_count();
+
+  /*
+   * The cpu may stay busy or idle longer than a turn of count without
+   * scheduling
+   */
+  kstat_cpu(get_current_pcb() == NULL, now);
+
+  /*
+   * check if there are some processes to wake up
+   */
+  process_sleep(now);
+
+  /*
+   * Did the current process use its whole time slice ?
+   */
+  p = get_current_pcb();
+  expired = (p != NULL && TIMER_REACHED(slice_end, now));
+
+  if (expired)
+    sched_expire(p);
+
+#if TICKLESS
+  /*
+   * Only reschedule if needed: nobody is running, the time slice is over
+   * or someone more important just woke up
+   */
+  q = rq_first(&rqready);
+
+  if (p == NULL || expired || sched_preempt(p, q))
+    schedule();
+#else
+  /*
+   * Reschedule all processes and reload timer for another QUANTUM
+   */
+  schedule();
+  kset_compare(now + QUANTUM);
+#endif
+
+  kset_cause(~0x8000, 0);       //clear the flag for timer interrupt
+}
+
+/**
+ * \private
+ * Program the timer for the next deadline
+ */
+void
+ktimer_program()
+{
+#if TICKLESS
+  uint32_t        now, next, date;
+  pcb            *p, *q;
+
+  now = kget_count();
+  next = now + TIMER_MAX_DELTA;
+
+  /*
+   * The end of the time slice only matters if the scheduler needs it
+   */
+  p = get_current_pcb();
+  q = rq_first(&rqready);
+
+  if (p != NULL && sched_need_slice(p))
+    next = slice_end;
+
+  /*
+   * Someone more prioritary is ready, or nobody runs: schedule as soon as
+   * possible. The syscalls and the uart interrupt already rescheduled at
+   * once (see sched_check_preempt), this is only the fallback.
+   */
+  if (sched_preempt(p, q))
+    next = now;
+
+  /*
+   * The first sleeping process to wake up
+   */
+  if (sleep_next(&date) && !TIMER_REACHED(next, date))
+    next = date;
+
+  /*
+   * Too close, or even already passed
+   */
+  if ((int32_t) (next - now) < TIMER_MIN_DELTA)
+    next = now + TIMER_MIN_DELTA;
+
+  kset_compare(next);
+#endif
+}
+
+/* end of file ktimer.c */
@@ -0,0 +1,76 @@
+/**
+ * \file ktimer.h
+ * \brief Manage the timer interrupt and the time slices.
+ *
+ * The count register runs freely from the boot, every date is an absolute
+ * value of count. With TICKLESS set, the compare register is programmed
+ * after each exception to the nearest deadline: the end of the time slice
+ * of the current process (only if the scheduler needs it, see
+ * sched_need_slice) or the wake up of the first sleeping process. Otherwise
+ * the timer ticks every QUANTUM, and the time slices are rounded to it.
+ */
+
+#ifndef __KTIMER_H
+#define __KTIMER_H
+
+#include <types.h>
+
+/**
+ * @brief Minimal delay between now and the next timer interrupt, a deadline
+ * nearer than that is delayed to it.
+ */
+#define TIMER_MIN_DELTA (20 * timer_usec)
+
+/**
+ * @brief Maximal delay between now and a deadline. The dates are compared
+ * on their difference, so they must not be more than half a turn of count
+ * away (around 32 s).
+ */
+#define TIMER_MAX_DELTA 0x7FFFFFFF
+
+/**
+ * @brief Is a date reached ?
+ * @param date the date to test
+ * @param now the current value of count
+ * @return TRUE if date is before or equal to now
+ */
+#define TIMER_REACHED(date, now) ((int32_t) ((date) - (now)) <= 0)
+
+/**
+ * @brief Start the timer. Must be called once, at the boot.
+ */
+void            ktimer_init();
+
+/**
+ * @brief Return the date a delay from now
+ * @param delay the delay, in count unit. Clamped to TIMER_MAX_DELTA
+ * @return the date
+ */
+uint32_t        ktimer_date(uint32_t delay);
+
+/**
+ * @brief Start a new time slice for the current process
+ * @param quantum the length of the slice, in count unit
+ */
+void            ktimer_slice_start(uint32_t quantum);
+
+/**
+ * @brief Handle the timer interrupt.
+ *
+ * Wake up the processes that are done sleeping, then reschedule if the time
+ * slice is over or a woken up process is more prioritary than the current
+ * one.
+ */
+void            ktimer_interrupt();
+
+/**
+ * @brief Program the timer for the next deadline (TICKLESS only).
+ *
+ * Called at the end of every exception, since a syscall or an interrupt may
+ * have changed the current process, the ready ones or the sleeping ones.
+ */
+void            ktimer_program();
+
+#endif
+
+/* end of file ktimer.h */
@@ -12,6 +12,17 @@
 #include <ns16550.h>
 #include "display.h"
 
+#ifdef HOST
+
+/* Host build: the devices are variables of the hal (see src/host/hal.h) */
+#include "hal.h"
+
+static volatile ds12887_t *const rtc = &hal_rtc;
+static volatile ns16550_t *const tty = &hal_tty;
+static volatile display_t *const malta = &hal_malta;
+
+#else
+
 #define IO_BASE1 0xb8000000
 #define IO_BASE2 0xbf000000
 #define IO_BASE3 0xbbe00000
@@ -38,6 +49,8 @@ IO_DEVICE2(display_t, malta, 0x400);
 #undef IO_DEVICE1
 #undef IO_DEVICE2
 
+#endif /* HOST */
+
 #endif /*  */
 
 /* end of file malta.h */
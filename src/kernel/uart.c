@@ -338,9 +338,8 @@ end_printing(int32_t code)
 void
 clean_uart()
 {
-  char            c;
   while (tty->lsr.field.dr)
-    c = tty->rbr;
+    (void) tty->rbr;
 }
 
 /*
@@ -9,7 +9,11 @@
 //#include "test_kpcb_fifo.c"
 //#include "test_kprocess_list2.c"
 //#include "test_kscheduler.c"
+//#include "test_krunqueue.c"
 //#include "test_ksleep.c"
+//#include "test_ksyscall.c"
+//#include "test_kstack.c"
+//#include "test_kbuf.c"
 //#include "test_kprocess2.c"
 //#include "test_uart_fifo.c"
 //#include "test_kprogram.c"
@@ -55,8 +59,16 @@ test()
 
   //test_kscheduler();
 
+  //test_krunqueue();
+
   //test_ksleep();
 
+  //test_ksyscall();
+
+  //test_kstack();
+
+  //test_kbuf();
+
   //test_kprocess2();
 
   //test_uart_fifo();
@@ -0,0 +1,152 @@
+/**
+ * @file test_kbuf.c
+ * @brief test the pool of the message buffers
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include "../kernel/kbuf.h"
+
+int32_t         test_kbuf_alloc();
+int32_t         test_kbuf_free();
+int32_t         test_kbuf_release();
+
+void
+test_kbuf()
+{
+  int             e;
+  char            c;
+
+  kprintln("--------------TEST MODULE KBUF BEGIN--------------");
+
+  kprint("Test kbuf_alloc\t\t\t\t\t");
+  e = test_kbuf_alloc();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, &c));
+  }
+
+  kprint("Test kbuf_free\t\t\t\t\t");
+  e = test_kbuf_free();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, &c));
+  }
+
+  kprint("Test kbuf_release\t\t\t\t");
+  e = test_kbuf_release();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, &c));
+  }
+
+  kprintln("--------------TEST MODULE KBUF END----------------\n");
+
+  kbuf_reset();
+}
+
+/*
+ * The buffers are next to each other, until there is none left
+ */
+int32_t
+test_kbuf_alloc()
+{
+  char           *a, *b;
+  uint32_t        i;
+
+  kbuf_reset();
+
+  a = kbuf_alloc(1);
+  b = kbuf_alloc(2);
+
+  if (a == NULL || b != a + KBUF_WORDS * sizeof(uint32_t)
+      || KBUF_WORDS * sizeof(uint32_t) < MSG_BUF_SIZE)
+    return -1;
+
+  if (kbuf_owner(a) != 1 || kbuf_owner(b) != 2)
+    return -2;
+
+  for (i = 2; i < MSG_BUFS; i++)
+    if (kbuf_alloc(1) == NULL)
+      return -3;
+
+  if (kbuf_alloc(1) != NULL || kbuf_free_count() != 0)
+    return -4;
+
+  return OMGROXX;
+}
+
+/*
+ * Only the owner gives a buffer back, once, and the buffer changes of
+ * owner when it is given
+ */
+int32_t
+test_kbuf_free()
+{
+  char           *a;
+
+  kbuf_reset();
+
+  a = kbuf_alloc(1);
+
+  /*
+   * Not the owner, not a buffer, not its beginning
+   */
+  if (kbuf_free(2, a) != INVARG || kbuf_free(1, &a) != INVARG
+      || kbuf_free(1, a + 1) != INVARG || kbuf_owner(a + 1) != KBUF_FREE)
+    return -1;
+
+  kbuf_give(a, 2);
+
+  if (kbuf_owner(a) != 2 || kbuf_free(1, a) != INVARG)
+    return -2;
+
+  if (kbuf_free(2, a) != OMGROXX || kbuf_free(2, a) != INVARG)
+    return -3;
+
+  if (kbuf_free_count() != MSG_BUFS || kbuf_owner(a) != KBUF_FREE)
+    return -4;
+
+  /*
+   * The last one given back is the next one taken
+   */
+  if (kbuf_alloc(3) != a)
+    return -5;
+
+  return OMGROXX;
+}
+
+/*
+ * A terminated process gives back all its buffers, not the other ones
+ */
+int32_t
+test_kbuf_release()
+{
+  char           *a;
+  uint32_t        i;
+
+  kbuf_reset();
+
+  for (i = 0; i < 6; i++)
+    a = kbuf_alloc(i % 2);
+
+  if (kbuf_release(1) != 3 || kbuf_free_count() != MSG_BUFS - 3)
+    return -1;
+
+  if (kbuf_owner(a) != KBUF_FREE || kbuf_release(1) != 0)
+    return -2;
+
+  if (kbuf_release(0) != 3 || kbuf_free_count() != MSG_BUFS)
+    return -3;
+
+  return OMGROXX;
+}
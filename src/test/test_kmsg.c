@@ -7,14 +7,191 @@
 #include "../kernel/kernel.h"
 #include "../kernel/kinout.h"
 #include "../kernel/kprocess.h"
+#include "../kernel/kprocess_list.h"
 #include "../kernel/kmsg.h"
+#include "../kernel/kbuf.h"
 
 void            test_unit(bool err, int res);
 
+/*
+ * The newest message of the mailbox of p
+ */
+static msg     *
+last_msg(pcb * p)
+{
+  return &p->messages.ls[p->messages.all.last].m;
+}
+
+/*
+ * Messages of 3 senders: the receive from one takes its message of highest
+ * priority, the others stay in order
+ */
+static int
+test_kmsg_mixed(pcb * p)
+{
+  msg             m;
+  int32_t         i;
+
+  reset_mls(&p->messages);
+
+  for (i = 0; i < 9; i++)
+  {
+    create_msg(&m, i % 3, 0, 10 + i % 2, (void *) i, INT_T);
+    push_mls(&p->messages, &m);
+  }
+
+  if (take_mls(&p->messages, FPID, 2, INT_T, &m) != OMGROXX
+      || (int) m.data != 5 || p->messages.length != 8)
+    return -1;
+
+  if (take_mls(&p->messages, FPRI, 11, INT_T, &m) != OMGROXX
+      || (int) m.data != 1)
+    return -2;
+
+  if (take_mls(&p->messages, FPID, 2, CHAR_PTR, &m) != NOTFOUND
+      || take_mls(&p->messages, FPRI, 12, INT_T, &m) != NOTFOUND
+      || take_mls(&p->messages, FPRI, MAX_MPRI + 1, INT_T, &m) != INVARG)
+    return -3;
+
+  /*
+   * A sender in the same bucket as 2
+   */
+  create_msg(&m, 2 + MSG_BUCKETS, 0, 10, (void *) 99, INT_T);
+  push_mls(&p->messages, &m);
+
+  if (take_mls(&p->messages, FPID, 2 + MSG_BUCKETS, INT_T, &m)
+      != OMGROXX || (int) m.data != 99)
+    return -4;
+
+  if (pop_mls(&p->messages, &m) != OMGROXX || (int) m.data != 0
+      || pop_mls(&p->messages, &m) != OMGROXX || (int) m.data != 2)
+    return -5;
+
+  /*
+   * Full
+   */
+  for (i = p->messages.length; i < MAX_MSG; i++)
+    push_mls(&p->messages, &m);
+
+  if (push_mls(&p->messages, &m) != OUTOMEM)
+    return -6;
+
+  reset_mls(&p->messages);
+
+  return OMGROXX;
+}
+
+/*
+ * The receive takes the message of highest priority, the oldest among
+ * equals, from any sender or from one
+ */
+static int
+test_kmsg_priority(pcb * p)
+{
+  msg             m;
+  int32_t         i;
+  int32_t         pri[6] = { BAS_MPRI, MIN_MPRI, BAS_MPRI, MAX_MPRI,
+    MIN_MPRI, MAX_MPRI
+  };
+  int32_t         order[6] = { 5, 3, 0, 2, 1, 4 };
+
+  reset_mls(&p->messages);
+
+  for (i = 0; i < 6; i++)
+  {
+    create_msg(&m, i % 2, 0, pri[i], (void *) i, INT_T);
+    push_mls(&p->messages, &m);
+  }
+
+  /*
+   * From the sender 1: 3, 5 then 1. 3 comes back, after 5
+   */
+  if (take_mls(&p->messages, FPID, 1, INT_T, &m) != OMGROXX
+      || (int) m.data != 3)
+    return -1;
+
+  create_msg(&m, 1, 0, MAX_MPRI, (void *) 3, INT_T);
+  push_mls(&p->messages, &m);
+
+  for (i = 0; i < 6; i++)
+    if (take_mls(&p->messages, FTYPE, INT_T, INT_T, &m) != OMGROXX
+        || (int) m.data != order[i])
+      return -2 - i;
+
+  if (p->messages.length != 0 || p->messages.pmap[INT_T] != 0)
+    return -8;
+
+  /*
+   * An urgent message passes the bulk ones
+   */
+  for (i = 0; i < MAX_MSG - 1; i++)
+  {
+    create_msg(&m, 0, 0, BAS_MPRI, (void *) i, INT_T);
+    push_mls(&p->messages, &m);
+  }
+
+  create_msg(&m, 1, 0, MAX_MPRI, (void *) -1, INT_T);
+  push_mls(&p->messages, &m);
+
+  if (take_mls(&p->messages, FNONE, 0, INT_T, &m) != OMGROXX
+      || (int) m.data != -1)
+    return -9;
+
+  reset_mls(&p->messages);
+
+  return OMGROXX;
+}
+
+/*
+ * A buffer goes from p to q without a copy, q owns it. One left in the
+ * mailbox goes back to the pool with q.
+ */
+static int
+test_kmsg_buf(pcb * p, pcb * q)
+{
+  char           *b, *r;
+  msg_arg         s = { NULL, BUF_T, 0, BAS_MPRI, -1, 0 };
+  msg_arg         ra = { &r, BUF_T, 0, 0, -1, FTYPE };
+
+  reset_mls(&q->messages);
+  kbuf_reset();
+
+  b = kbuf_alloc(pcb_get_pid(p));
+  strcpy("zero copy", b);
+
+  s.data = b;
+  s.pid = pcb_get_pid(q);
+
+  if (send_msg(pcb_get_pid(q), &s) != INVARG)
+    return -1;
+
+  if (send_msg(pcb_get_pid(p), &s) != OMGROXX
+      || kbuf_owner(b) != pcb_get_pid(q) || kbuf_free(pcb_get_pid(p), b)
+      != INVARG)
+    return -2;
+
+  if (recv_msg(pcb_get_pid(q), &ra) != pcb_get_pid(p) || r != b
+      || strcmp(r, "zero copy") != 0)
+    return -3;
+
+  if (kbuf_free(pcb_get_pid(q), r) != OMGROXX
+      || kbuf_free_count() != MSG_BUFS)
+    return -4;
+
+  s.data = kbuf_alloc(pcb_get_pid(p));
+  send_msg(pcb_get_pid(p), &s);
+
+  if (kbuf_release(pcb_get_pid(q)) != 1 || kbuf_free_count() != MSG_BUFS)
+    return -5;
+
+  reset_mls(&q->messages);
+
+  return OMGROXX;
+}
+
 void
 test_kmsg()
 {
-  char            c[10];
   pcb            *pcb0, *pcb1;
   msg             m1;
   msg             m2;
@@ -53,19 +230,29 @@ test_kmsg()
   strcpy("1234", params[4]);
   kprintln("--------------TEST MODULE KMSG BEGIN--------------");
 
-  create_proc("init", 10, 5, (char **) params);
-  create_proc("init", 11, 5, (char **) params);
-  create_proc("init", 12, 5, (char **) params);
+  rq_reset(&rqready);
+  pls_reset(&plsrunning);
+  pls_reset(&plswaiting);
+  pls_reset(&plssleeping);
+  pls_reset(&plsterminate);
+  reset_next_pid();
+  reset_used_stack();
+  init_mem();
+
+  create_proc("increment", 10, 4, (char **) params);
+  create_proc("increment", 11, 4, (char **) params);
+  create_proc("increment", 12, 4, (char **) params);
 
   kprint("create_msg\t\t\t\t\t");
   pcb0 = search_all_list(0);
   pcb1 = search_all_list(1);
 
+  res = OMGROXX;
   res0 = create_msg(NULL, 0, 1, 10, mess1, CHAR_PTR);   //CREATE 1
   res1 = create_msg(&m1, 0, 1, 10, NULL, CHAR_PTR);     //CREATE 1
   res2 = create_msg(&m1, 0, 1, 10, mess1, CHAR_PTR);    //CREATE 1
   err = (res0 == NULLPTR) &&
-    (res1 == NULLPTR) &&
+    (res1 == OMGROXX) &&
     (res2 == OMGROXX) &&
     (m1.sdr_pid == 0) &&
     (m1.recv_pid == 1) &&
@@ -88,7 +275,7 @@ test_kmsg()
 
   kprint("push_mls\t\t\t\t\t"); //PUSH
   res = push_mls(&pcb0->messages, &m1);
-  m = &pcb0->messages.ls[0];
+  m = last_msg(pcb0);
   err = (res == OMGROXX) &&
     (m->sdr_pid == 0) &&
     (m->recv_pid == 1) &&
@@ -112,7 +299,7 @@ test_kmsg()
 
   kprint("send_msg string 1\t\t\t\t");
   res = send_msg(0, &msgarga);  // process 0 send a message to process 1
-  mb = &pcb1->messages.ls[0];
+  mb = last_msg(pcb1);
   err = (res == OMGROXX) &&
     (mb != NULL) &&
     (mb->sdr_pid == 0) &&
@@ -124,7 +311,7 @@ test_kmsg()
 
   kprint("send_msg string 2\t\t\t\t");
   res = send_msg(1, &msgargb);  // process 1 send a message to process 0
-  mb = &pcb0->messages.ls[0];
+  mb = last_msg(pcb0);
   err = (res == OMGROXX) &&
     (mb != NULL) &&
     (mb->sdr_pid == 1) &&
@@ -136,7 +323,7 @@ test_kmsg()
 
   kprint("send_msg string 3\t\t\t\t");  //SEND_MSG
   res = send_msg(1, &msgargc);  // process 1 send a message to process 0
-  mb = &pcb0->messages.ls[1];
+  mb = last_msg(pcb0);
   err = (res == OMGROXX) &&
     (mb != NULL) &&
     (mb->sdr_pid == 1) &&
@@ -148,13 +335,13 @@ test_kmsg()
 
   kprint("recv_msg string 1\t\t\t\t");  //RECV_MSG
   res = recv_msg(0, &msgargres);        // process 0 wants to receive a CHAR_PTR and put it in messres
-  err = (res == OMGROXX) &&
+  err = (res == 1) &&
     (strcmp(messres, "Hello2") == 0) && (pcb0->messages.length == 1);
   test_unit(err, res);
 
   kprint("send_msg int 1\t\t\t\t\t");   //SEND_MSG
   res = send_msg(1, &msgarg2);
-  mb = &pcb0->messages.ls[2];
+  mb = last_msg(pcb0);
   err = (res == OMGROXX) &&
     (mb != NULL) &&
     (mb->sdr_pid == 1) &&
@@ -165,32 +352,38 @@ test_kmsg()
   test_unit(err, res);
 
   kprint("recv_msg int 1\t\t\t\t\t");   //RECV_MSG
-  res = recv_msg(0, &msgargres2);       // process 0 wants to receive a INT_T and put it in messres2
-  err = (res == OMGROXX) && (messres2 == 5) && (pcb0->messages.length == 0);
+  res = recv_msg(0, &msgargres2);       // process 0 wants to receive a INT_T and put it in messres2, "Hello3" stays
+  err = (res == 1) && (messres2 == 5) && (pcb0->messages.length == 1);
   test_unit(err, res);
 
   kprint("send_msg string 4\t\t\t\t");  //SEND_MSG
   res = send_msg(1, &msgarg3);
-  mb = &pcb0->messages.ls[3];
+  mb = last_msg(pcb0);
   err = (res == OMGROXX) &&
     (mb->sdr_pid == 1) &&
     (mb->recv_pid == 0) &&
     (mb->pri == 13) &&
     (strcmp(mb->data, "other") == 0) &&
-    (mb->datatype == CHAR_PTR) && (pcb0->messages.length == 1);
+    (mb->datatype == CHAR_PTR) && (pcb0->messages.length == 2);
   test_unit(err, res);
 
   kprint("recv_msg string 4\t\t\t\t");  //RECV_MSG
-  res = recv_msg(0, &msgargres3);       // process 0 wants to receive a CHAR_T and put it in messres3
-  err = (res == 0) &&
-    (strcmp(messres3, "other") == 0) && (pcb0->messages.length == 0);
+  res = recv_msg(0, &msgargres3);       // process 0 wants to receive a CHAR_T and put it in messres3: the one of highest priority
+  err = (res == 1) &&
+    (strcmp(messres3, "other") == 0) && (pcb0->messages.length == 1);
+  test_unit(err, res);
+
+  kprint("recv_msg string 5\t\t\t\t");  //RECV_MSG
+  res = recv_msg(0, &msgargres3);
+  err = (res == 1) &&
+    (strcmp(messres3, "Hello3") == 0) && (pcb0->messages.length == 0);
   test_unit(err, res);
 
 
 
   kprint("send_msg by PID\t\t\t\t\t");  //SEND_MSG
   res = send_msg(1, &msgarg4);
-  mb = &pcb0->messages.ls[4];
+  mb = last_msg(pcb0);
   err = (res == OMGROXX) &&
     (mb->sdr_pid == 1) &&
     (mb->recv_pid == 0) &&
@@ -201,7 +394,7 @@ test_kmsg()
 
   kprint("send_msg by PID\t\t\t\t\t");  //SEND_MSG
   res = send_msg(1, &msgarg5);
-  mb = &pcb0->messages.ls[5];
+  mb = last_msg(pcb0);
   err = (res == OMGROXX) &&
     (mb->sdr_pid == 1) &&
     (mb->recv_pid == 0) &&
@@ -217,7 +410,7 @@ test_kmsg()
 
   kprint("recv_msg by PRIO\t\t\t\t");   //RECV_MSG
   res = recv_msg(0, &msgargres5);       // process 0 wants to receive a INT_T wit prio = 15 and put it in messres5
-  err = (res == 0) && ((int) messres5 == 43) && (pcb0->messages.length == 0);
+  err = (res == 1) && ((int) messres5 == 43) && (pcb0->messages.length == 0);
   test_unit(err, res);
 
   kprint("recv_msg by PID\t\t\t\t\t");  //RECV_MSG
@@ -228,9 +421,20 @@ test_kmsg()
 
   kprint("recv_msg string with wait\t\t\t");    //RECV_MSG
   res = recv_msg(0, &msgargres7);       // process 0 wants to receive a CHAR_PTR and put it in messres
-  err = (res == FAILNOOB) && (pcb0->messages.length == 0);
+  err = (res == NOTFOUND) && (pcb0->messages.length == 0);
   test_unit(err, res);
-  c[0] = '\0';
+
+  kprint("recv_msg mixed senders\t\t\t\t");      //RECV_MSG
+  res = test_kmsg_mixed(pcb0);
+  test_unit(res == OMGROXX, res);
+
+  kprint("recv_msg by priority\t\t\t\t");        //RECV_MSG
+  res = test_kmsg_priority(pcb0);
+  test_unit(res == OMGROXX, res);
+
+  kprint("send_msg buffer\t\t\t\t\t");      //SEND_MSG
+  res = test_kmsg_buf(pcb0, pcb1);
+  test_unit(res == OMGROXX, res);
 
   kprintln("---------------TEST MODULE KMSG END---------------");
   kprintln("");
@@ -56,7 +56,7 @@ test_kpcb()
   }
 
 
-  kprint("Test pcb_get_supervised\t\t\t\t");
+  kprint("Test pcb_get_child\t\t\t\t");
   e = test_pcb_set_get_supervised();
   if (e == OMGROXX)
     kprintln("OK");
@@ -193,42 +193,46 @@ test_pcb_set_get_pri()
 uint32_t
 test_pcb_set_get_supervised()
 {
-  pcb             p;
-  int32_t        *s, i;
+  pcb             p, q, c[3];
+  uint32_t        i;
 
-  pcb_reset_supervised(&p);
-  s = pcb_get_supervised(&p);
+  pcb_reset(&p);
+  pcb_reset(&q);
 
-  for (i = 0; i < MAXPCB; i++)
-    if (s[i] != -1)
-      return -1;
+  if (pcb_get_child(&p) != NULL)
+    return -1;
 
-  pcb_set_supervised(&p, 0);
+  for (i = 0; i < 3; i++)
+  {
+    pcb_reset(&c[i]);
+    pcb_add_child(&p, &c[i]);
+  }
 
-  s = pcb_get_supervised(&p);
-  if (s[0] != 0)
+  /*
+   * The children are added at the front: c2 c1 c0
+   */
+  if (pcb_get_child(&p) != &c[2] || pcb_get_sibling(&c[2]) != &c[1]
+      || pcb_get_sibling(&c[1]) != &c[0] || pcb_get_sibling(&c[0]) != NULL)
     return -2;
 
-  for (i = 0; i < MAXPCB; i++)
-    pcb_set_supervised(&p, i);
+  pcb_rm_child(&c[1]);
 
-  s = pcb_get_supervised(&p);
+  if (pcb_get_sibling(&c[2]) != &c[0] || pcb_get_parent(&c[1]) != NULL)
+    return -3;
 
-  for (i = 0; i < MAXPCB; i++)
-    if (s[i] != i)
-      return -3;
+  /*
+   * q adopts the children of p: c2 c0 c1
+   */
+  pcb_add_child(&q, &c[1]);
+  pcb_adopt(&q, &p);
 
-  if (pcb_set_supervised(&p, 123) != OUTOMEM)
+  if (pcb_get_child(&p) != NULL || pcb_get_child(&q) != &c[2]
+      || pcb_get_sibling(&c[0]) != &c[1])
     return -4;
 
-  pcb_rm_supervised(&p, 32);
-  s = pcb_get_supervised(&p);
-
-  if (s[32] != -1)
-    return -5;
-
-  if (pcb_set_supervised(&p, 123) != OMGROXX)
-    return -6;
+  for (i = 0; i < 3; i++)
+    if (pcb_get_parent(&c[i]) != &q)
+      return -5;
 
   return OMGROXX;
 }
@@ -82,7 +82,7 @@ test_push_fifo_p(void)
 {
   fifo_p         *fifo;
   uint32_t        j;
-  pcb             pcbs[MAXPCB + 1];
+  static pcb      pcbs[MAXPCB + 1];
 
   reset_fifo_p();
   fifo = get_fifo_p();
@@ -122,7 +122,8 @@ test_pop_fifo_p(void)
 {
   fifo_p         *fifo;
   uint32_t        j;
-  pcb             pcbs[MAXPCB + 1], *p;
+  static pcb      pcbs[MAXPCB + 1];
+  pcb            *p;
 
   fifo = get_fifo_p();
   reset_fifo_p();
@@ -21,7 +21,7 @@ test_kprocess2()
   int             e;
   char            c;
 
-  pls_reset(&plsready);
+  rq_reset(&rqready);
   pls_reset(&plsrunning);
   pls_reset(&plswaiting);
   pls_reset(&plsterminate);
@@ -107,7 +107,7 @@ test_get_next_pid()
   p = &pcb_array[0];
   pcb_reset(p);
   pcb_set_pid(p, get_next_pid());
-  pls_add(&plsready, p);
+  rq_add(&rqready, p);
 
   /*
    * Now gimme mooaaaaaare
@@ -118,7 +118,7 @@ test_get_next_pid()
   /*
    * Reset everything
    */
-  pls_reset(&plsready);
+  rq_reset(&rqready);
   pcb_reset(p);
 
   /*
@@ -211,7 +211,7 @@ test_create_proc()
   if (create_proc("init", 12, (char **) arg) < 0)
     return -5;
 
-  if (strcmp(pcb_get_name(plsready.start), "init") != 0)
+  if (strcmp(pcb_get_name(rq_first(&rqready)), "init") != 0)
     return -42;
 
   for (i = 0; i < MAXPCB - 1; i++)
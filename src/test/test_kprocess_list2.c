@@ -4,6 +4,7 @@
 #include <string.h>
 #include "../kernel/kprocess_list.h"
 #include "../kernel/debug.h"
+#include "../kernel/kinout.h"
 
 
 uint32_t        test_pls_reset();
@@ -13,6 +14,7 @@ uint32_t        test_pls_move_pcb();
 uint32_t        test_pls_item_reset();
 uint32_t        test_pls_search_pcb();
 uint32_t        test_pls_search_pid();
+uint32_t        test_pls_find_pid();
 uint32_t        test_pls_item_alloc();
 uint32_t        test_pls_item_cpy_pcb();
 
@@ -62,6 +64,16 @@ test_kprocess_list2()
     kprintln(itos(e, &c));
   }
 
+  kprint("Test pls_find_pid\t\t\t\t");
+  e = test_pls_find_pid();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, &c));
+  }
+
   kprint("Test pls_delete_pcb\t\t\t\t");
   e = test_pls_delete_pcb();
   if (e == OMGROXX)
@@ -269,6 +281,27 @@ test_pls_search_pid()
   return OMGROXX;
 }
 
+uint32_t
+test_pls_find_pid()
+{
+  /*
+   * The pid is found in any list
+   */
+  if (pls_find_pid(0) != &p_array[0])
+    return -1;
+
+  if (pls_find_pid(2) != &p_array[2])
+    return -2;
+
+  /*
+   * An other pid of the same slot is not found
+   */
+  if (pls_find_pid(2 + PID_SLOTS) != NULL)
+    return -3;
+
+  return OMGROXX;
+}
+
 uint32_t
 test_pls_delete_pcb()
 {
@@ -288,7 +321,7 @@ test_pls_delete_pcb()
   if (pcb_get_empty(p) != TRUE)
     return -2;
 
-  if (pls_search_pid(&ls2, 3) != NULL)
+  if (pls_search_pid(&ls2, 3) != NULL || pls_find_pid(3) != NULL)
     return -3;
 
   if (ls2.length != 3)
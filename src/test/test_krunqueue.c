@@ -0,0 +1,386 @@
+/**
+ * @file test_krunqueue.c
+ * @brief Test the run queue, and compare it with the sorted pcb list
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include "../kernel/kernel.h"
+#include "../kernel/kinout.h"
+#include "../kernel/krunqueue.h"
+
+/**
+ * @brief Number of enqueue/dequeue rounds of the benchmark
+ */
+#define BENCH_ROUNDS 100
+
+int32_t         test_rq_add();
+int32_t         test_rq_first();
+int32_t         test_rq_remove();
+int32_t         test_rq_stride();
+void            bench_krunqueue();
+
+static runqueue rq;
+static pls      ls;
+static pcb      rq_array[MAXPCB];       // A set of pcb for the test
+
+void
+test_krunqueue()
+{
+  int             e;
+  char            c[12];
+
+  kprintln("-------------TEST MODULE RUNQUEUE BEGIN-----------");
+
+  kprint("Test rq_add\t\t\t\t\t");
+  e = test_rq_add();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, c));
+  }
+
+#if SCHED_POLICY == SCHED_STRIDE
+  kprint("Test the heap of the stride scheduler\t\t");
+  e = test_rq_stride();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, c));
+  }
+#else
+  kprint("Test rq_first\t\t\t\t\t");
+  e = test_rq_first();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, c));
+  }
+
+  kprint("Test remove from the run queue\t\t\t");
+  e = test_rq_remove();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, c));
+  }
+#endif
+
+  bench_krunqueue();
+
+  kprintln("-------------TEST MODULE RUNQUEUE END-------------\n");
+}
+
+/*
+ * Set a pcb of the test array
+ */
+static pcb     *
+rq_test_pcb(uint32_t i, uint32_t pri)
+{
+  pcb            *p = &rq_array[i];
+
+  pcb_reset(p);
+  pcb_set_pid(p, i);
+  pcb_set_pri(p, pri);
+  pcb_set_state(p, READY);
+  pcb_set_empty(p, FALSE);
+
+  return p;
+}
+
+int32_t
+test_rq_add()
+{
+  pcb            *p;
+
+  rq_reset(&rq);
+
+  p = rq_test_pcb(0, 12);
+
+  if (rq_add(&rq, p) != OMGROXX)
+    return -1;
+
+  if (!rq_has(&rq, p) || pcb_get_head(p) != rq_level(&rq, 12))
+    return -2;
+
+  if (rq.map[0] != (1 << 12) || rq.map[1] != 0)
+    return -3;
+
+  /*
+   * Same priority: it goes behind
+   */
+  p = rq_test_pcb(1, 12);
+  rq_add(&rq, p);
+
+  if (rq_level(&rq, 12)->start != &rq_array[0]
+      || rq_level(&rq, 12)->end != p || rq_level(&rq, 12)->length != 2)
+    return -4;
+
+  /*
+   * Adding it again move it to the end of its level
+   */
+  rq_add(&rq, &rq_array[0]);
+
+  if (rq_level(&rq, 12)->start != p
+      || rq_level(&rq, 12)->end != &rq_array[0]
+      || rq_level(&rq, 12)->length != 2)
+    return -5;
+
+  /*
+   * A priority change move it to its new level
+   */
+  pcb_set_pri(p, MAX_PRI);
+  rq_add(&rq, p);
+
+  if (rq_level(&rq, 12)->length != 1 || rq_level(&rq, MAX_PRI)->start != p)
+    return -6;
+
+  if (rq.map[0] != (1 << 12) || rq.map[MAX_PRI / 32] == 0)
+    return -7;
+
+  if (rq_search_pid(&rq, 1) != p || rq_search_pid(&rq, 42) != NULL)
+    return -8;
+
+  return OMGROXX;
+}
+
+int32_t
+test_rq_first()
+{
+  rq_reset(&rq);
+
+  if (rq_first(&rq) != NULL)
+    return -1;
+
+  rq_add(&rq, rq_test_pcb(0, 2));
+  rq_add(&rq, rq_test_pcb(1, 21));
+  rq_add(&rq, rq_test_pcb(2, 21));
+
+  if (rq_first(&rq) != &rq_array[1])
+    return -2;
+
+  rq_add(&rq, rq_test_pcb(3, MAX_PRI));
+
+  if (rq_first(&rq) != &rq_array[3])
+    return -3;
+
+  rq_add(&rq, rq_test_pcb(4, MIN_PRI));
+
+  if (rq_first(&rq) != &rq_array[3])
+    return -4;
+
+  return OMGROXX;
+}
+
+int32_t
+test_rq_remove()
+{
+  /*
+   * Keep the run queue of the previous test:
+   * 42: 3 / 21: 1 2 / 2: 0 / 0: 4
+   */
+  pls_reset(&ls);
+
+  pls_move_pcb(&rq_array[3], &ls);
+
+  if (rq_has(&rq, &rq_array[3]) || rq_level(&rq, MAX_PRI)->length != 0)
+    return -1;
+
+  if (rq.map[MAX_PRI / 32] & (1 << (MAX_PRI % 32)))
+    return -2;
+
+  if (rq_first(&rq) != &rq_array[1])
+    return -3;
+
+  pls_move_pcb(&rq_array[1], &ls);
+  pls_move_pcb(&rq_array[2], &ls);
+
+  if (rq_first(&rq) != &rq_array[0])
+    return -4;
+
+  pls_delete_pcb(&rq_array[0]);
+  pls_delete_pcb(&rq_array[4]);
+
+  if (rq_first(&rq) != NULL || rq.map[0] != 0)
+    return -5;
+
+  pls_reset(&ls);
+
+  return OMGROXX;
+}
+
+#if SCHED_POLICY == SCHED_STRIDE
+int32_t
+test_rq_stride()
+{
+  uint32_t        i;
+
+  rq_reset(&rq);
+  pls_reset(&ls);
+
+  /*
+   * The smallest pass first, whatever the priority
+   */
+  rq_test_pcb(0, MAX_PRI);
+  pcb_set_pass(&rq_array[0], 30);
+  rq_add(&rq, &rq_array[0]);
+
+  rq_test_pcb(1, MIN_PRI);
+  pcb_set_pass(&rq_array[1], 10);
+  rq_add(&rq, &rq_array[1]);
+
+  rq_test_pcb(2, BAS_PRI);
+  pcb_set_pass(&rq_array[2], 20);
+  rq_add(&rq, &rq_array[2]);
+
+  if (rq_first(&rq) != &rq_array[1] || rq.vtime != 10)
+    return -1;
+
+  /*
+   * A removed process is skipped
+   */
+  pls_move_pcb(&rq_array[1], &ls);
+
+  if (rq_first(&rq) != &rq_array[2])
+    return -2;
+
+  /*
+   * Coming back, it catches up with the virtual time
+   */
+  rq_add(&rq, &rq_array[1]);
+
+  if (pcb_get_pass(&rq_array[1]) != 20)
+    return -3;
+
+  /*
+   * The passes wrap
+   */
+  rq_reset(&rq);
+  pls_reset(&ls);
+  rq.vtime = 0xFFFFFFE0;
+
+  pcb_set_pass(&rq_array[0], 0xFFFFFFF0);
+  rq_add(&rq, &rq_array[0]);
+  pcb_set_pass(&rq_array[1], 5);
+  rq_add(&rq, &rq_array[1]);
+
+  if (rq_first(&rq) != &rq_array[0])
+    return -4;
+
+  pcb_set_pass(&rq_array[2], 0xFFFFFF00);
+  rq_add(&rq, &rq_array[2]);
+
+  if (rq_first(&rq) == &rq_array[1]
+      || pcb_get_pass(&rq_array[2]) != 0xFFFFFFF0)
+    return -5;
+
+  pls_move_pcb(&rq_array[2], &ls);
+
+  /*
+   * Many out of date entries: the heap is rebuilt
+   */
+  for (i = 0; i < 3 * RQ_HEAP; i++)
+  {
+    pcb_set_pass(&rq_array[1], pcb_get_pass(&rq_array[1]) + 1);
+    rq_add(&rq, &rq_array[1]);
+  }
+
+  if (rq.heap_len > RQ_HEAP || rq_first(&rq) != &rq_array[0])
+    return -6;
+
+  pls_move_pcb(&rq_array[0], &ls);
+
+  if (rq_first(&rq) != &rq_array[1] || rq_first(&rq) != &rq_array[1])
+    return -7;
+
+  pls_move_pcb(&rq_array[1], &ls);
+
+  if (rq_first(&rq) != NULL || rq.heap_len != 0)
+    return -8;
+
+  pls_reset(&ls);
+
+  return OMGROXX;
+}
+#endif
+
+/*
+ * Print a result of the benchmark, in ticks of the count register: it runs
+ * at half the CPU clock
+ */
+static void
+bench_print(char *name, uint32_t count, uint32_t ops)
+{
+  char            c[12];
+
+  kprint(name);
+  kprint(itos(count / ops, c));
+  kprintln(" count ticks/op");
+}
+
+/**
+ * Compare the run queue and the sorted list: MAXPCB processes of various
+ * priorities are added, then the most prioritary one is taken out until
+ * the queue is empty.
+ */
+void
+bench_krunqueue()
+{
+  uint32_t        i, j, t;
+  uint32_t        add_ls, first_ls, add_rq, first_rq;
+  pcb            *p;
+
+  add_ls = first_ls = add_rq = first_rq = 0;
+
+  for (j = 0; j < BENCH_ROUNDS; j++)
+  {
+    for (i = 0; i < MAXPCB; i++)
+      rq_test_pcb(i, (i * 7) % (MAX_PRI + 1));
+
+    /*
+     * Sorted list
+     */
+    pls_reset(&ls);
+
+    t = kget_count();
+    for (i = 0; i < MAXPCB; i++)
+      pls_add(&ls, &rq_array[i]);
+    add_ls += kget_count() - t;
+
+    t = kget_count();
+    while ((p = ls.start) != NULL)
+      pls_remove(p);
+    first_ls += kget_count() - t;
+
+    /*
+     * Run queue
+     */
+    rq_reset(&rq);
+
+    t = kget_count();
+    for (i = 0; i < MAXPCB; i++)
+      rq_add(&rq, &rq_array[i]);
+    add_rq += kget_count() - t;
+
+    t = kget_count();
+    while ((p = rq_first(&rq)) != NULL)
+      pls_remove(p);
+    first_rq += kget_count() - t;
+  }
+
+  bench_print("Bench pls_add\t\t\t\t\t", add_ls, BENCH_ROUNDS * MAXPCB);
+  bench_print("Bench rq_add\t\t\t\t\t", add_rq, BENCH_ROUNDS * MAXPCB);
+  bench_print("Bench pls dequeue first\t\t\t\t", first_ls,
+              BENCH_ROUNDS * MAXPCB);
+  bench_print("Bench rq dequeue first\t\t\t\t", first_rq,
+              BENCH_ROUNDS * MAXPCB);
+}
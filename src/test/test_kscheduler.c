@@ -10,8 +10,14 @@
 #include "../kernel/kprogram.h"
 #include "../kernel/kernel.h"
 #include "../kernel/kscheduler.h"
+#include "../kernel/kstat.h"
+#include "../kernel/kinout.h"
 
 int32_t         test_schedule();
+int32_t         test_sched_feedback();
+int32_t         test_sched_inherit();
+int32_t         test_sched_stat();
+int32_t         test_sched_stride();
 
 static pcb      parray[MAXPCB]; // A set of pcb for the test
 
@@ -24,6 +30,11 @@ test_kscheduler()
   kprintln("------------TEST MODULE SCHEDULER BEGIN-----------");
 
 
+  /*
+   * The order of test_schedule and test_sched_inherit is the one of the
+   * priorities, the stride scheduler does not follow it
+   */
+#if SCHED_POLICY != SCHED_STRIDE
   kprint("Test the scheduler\t\t\t\t");
   e = test_schedule();
   if (e == OMGROXX)
@@ -34,6 +45,53 @@ test_kscheduler()
     kprintln(itos(e, &c));
   }
 
+#endif
+
+  kprint("Test the feedback of the scheduler\t\t");
+  e = test_sched_feedback();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, &c));
+  }
+
+#if SCHED_POLICY != SCHED_STRIDE
+  kprint("Test the priority inheritance\t\t\t");
+  e = test_sched_inherit();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, &c));
+  }
+
+#endif
+
+  kprint("Test the statistics of the scheduler\t\t");
+  e = test_sched_stat();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, &c));
+  }
+
+#if SCHED_POLICY == SCHED_STRIDE
+  kprint("Test the stride scheduling\t\t\t");
+  e = test_sched_stride();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, &c));
+  }
+#endif
+
   kprintln("------------TEST MODULE SCHEDULER END-------------\n");
 }
 
@@ -42,17 +100,18 @@ test_schedule()
 {
   /*
    * First a simple case:
-   * A process with a priority of 42 is in the ready list.
+   * A process with a priority of 41 is in the run queue.
    * And the running list is empty.
    */
 
   pcb            *p;
 
-  pls_reset(&plsready);
+  rq_reset(&rqready);
   pls_reset(&plsrunning);
+  set_current_pcb(NULL);
 
   /*
-   * We add the pri41 to plsready
+   * We add the pri41 to the run queue
    */
   p = &parray[0];
   pcb_reset(p);
@@ -61,7 +120,7 @@ test_schedule()
   pcb_set_state(p, READY);
   pcb_set_empty(p, FALSE);
   pcb_set_epc(p, (uint32_t) init);
-  pls_add(&plsready, p);
+  rq_add(&rqready, p);
 
   /*
    * Go Go Scheduler!
@@ -72,14 +131,14 @@ test_schedule()
       || pcb_get_state(plsrunning.start) != RUNNING)
     return -1;
 
-  if (plsready.start != NULL)
+  if (rq_first(&rqready) != NULL)
     return -2;
 
   if (get_current_pcb() != plsrunning.start)
     return -3;
 
   /*
-   * So now, nobody is in ready but running have on pcb
+   * So now, nobody is ready but running have on pcb
    * What if i reschedule ?
    */
   schedule();
@@ -88,14 +147,14 @@ test_schedule()
       || pcb_get_state(plsrunning.start) != RUNNING)
     return -4;
 
-  if (plsready.start != NULL)
+  if (rq_first(&rqready) != NULL)
     return -5;
 
   if (get_current_pcb() != plsrunning.start)
     return -6;
 
   /*
-   * Now we add pri12 inside the ready list
+   * Now we add pri2 inside the run queue
    */
   p = &parray[1];
   pcb_reset(p);
@@ -103,12 +162,12 @@ test_schedule()
   pcb_set_pri(p, 2);
   pcb_set_state(p, READY);
   pcb_set_empty(p, FALSE);
-  pls_add(&plsready, p);
+  rq_add(&rqready, p);
 
   schedule();
 
-  if (strcmp(pcb_get_name(plsready.start), "pri2") != 0
-      || pcb_get_state(plsready.start) != READY)
+  if (strcmp(pcb_get_name(rq_first(&rqready)), "pri2") != 0
+      || pcb_get_state(rq_first(&rqready)) != READY)
     return -6;
 
   if (strcmp(pcb_get_name(plsrunning.start), "pri41") != 0
@@ -119,7 +178,7 @@ test_schedule()
     return -8;
 
   /*
-   * Now we add a new 41
+   * Now we add a new 41, the two 41 share the cpu (Round Robin)
    */
 
   p = &parray[2];
@@ -128,27 +187,30 @@ test_schedule()
   pcb_set_pri(p, 41);
   pcb_set_state(p, READY);
   pcb_set_empty(p, FALSE);
-  pls_add(&plsready, p);
+  rq_add(&rqready, p);
 
   schedule();
 
-  if (strcmp(pcb_get_name(plsready.start), "pri2") != 0
-      || pcb_get_state(plsready.start) != READY)
+  if (strcmp(pcb_get_name(plsrunning.start), "pri412") != 0
+      || pcb_get_state(plsrunning.start) != RUNNING
+      || plsrunning.length != 1)
     return -9;
 
-  if (strcmp(pcb_get_name(pcb_get_next(plsrunning.start)), "pri412") != 0
-      || pcb_get_state(pcb_get_next(plsrunning.start)) != RUNNING)
+  if (strcmp(pcb_get_name(rq_first(&rqready)), "pri41") != 0
+      || pcb_get_state(rq_first(&rqready)) != READY)
     return -10;
 
-  if (strcmp(pcb_get_name(plsrunning.start), "pri41") != 0
-      || pcb_get_state(plsrunning.start) != RUNNING)
+  schedule();
+
+  if (strcmp(pcb_get_name(get_current_pcb()), "pri41") != 0
+      || get_current_pcb() != plsrunning.start)
     return -11;
 
-  if (get_current_pcb() != pcb_get_next(plsrunning.start))
+  if (strcmp(pcb_get_name(rq_level(&rqready, 2)->start), "pri2") != 0)
     return -12;
 
   /*
-   * We add 42 to the ready list
+   * We add 42 to the run queue
    */
 
   p = &parray[3];
@@ -157,19 +219,19 @@ test_schedule()
   pcb_set_pri(p, 42);
   pcb_set_state(p, READY);
   pcb_set_empty(p, FALSE);
-  pls_add(&plsready, p);
+  rq_add(&rqready, p);
 
   schedule();
 
-  if (strcmp(pcb_get_name(plsready.start), "pri41") != 0
-      || pcb_get_state(plsready.start) != READY)
+  p = rq_level(&rqready, 41)->start;
+  if (strcmp(pcb_get_name(p), "pri412") != 0 || pcb_get_state(p) != READY)
     return -13;
 
-  p = pcb_get_next(plsready.start);
-  if (strcmp(pcb_get_name(p), "pri412") != 0 || pcb_get_state(p) != READY)
+  p = pcb_get_next(p);
+  if (strcmp(pcb_get_name(p), "pri41") != 0 || pcb_get_state(p) != READY)
     return -14;
 
-  p = pcb_get_next(p);
+  p = rq_level(&rqready, 2)->start;
   if (strcmp(pcb_get_name(p), "pri2") != 0 || pcb_get_state(p) != READY)
     return -15;
 
@@ -177,7 +239,7 @@ test_schedule()
       || pcb_get_state(plsrunning.start) != RUNNING)
     return -16;
 
-  pls_reset(&plsready);
+  rq_reset(&rqready);
   pls_reset(&plsrunning);
 
   schedule();
@@ -187,3 +249,394 @@ test_schedule()
 
   return OMGROXX;
 }
+
+int32_t
+test_sched_feedback()
+{
+  /*
+   * A cpu bound and an interactive process of the same priority
+   */
+  pcb            *cpu, *io;
+
+  rq_reset(&rqready);
+  pls_reset(&plsrunning);
+  pls_reset(&plswaiting);
+  set_current_pcb(NULL);
+
+  cpu = &parray[0];
+  pcb_reset(cpu);
+  pcb_set_pid(cpu, 1);
+  pcb_set_name(cpu, "cpu");
+  pcb_set_pri(cpu, BAS_PRI);
+  pcb_set_state(cpu, READY);
+  pcb_set_empty(cpu, FALSE);
+  rq_add(&rqready, cpu);
+
+  io = &parray[1];
+  pcb_reset(io);
+  pcb_set_pid(io, 2);
+  pcb_set_name(io, "io");
+  pcb_set_pri(io, BAS_PRI);
+  pcb_set_state(io, READY);
+  pcb_set_empty(io, FALSE);
+  rq_add(&rqready, io);
+
+  schedule();
+
+  if (get_current_pcb() != cpu)
+    return -1;
+
+  /*
+   * The cpu bound one uses its whole slice, twice
+   */
+  sched_expire(cpu);
+  schedule();
+  sched_expire(io);
+  kblock_pcb(io, WAITING_IO);
+
+  if (get_current_pcb() != cpu)
+    return -2;
+
+  sched_expire(cpu);
+
+#if SCHED_POLICY == SCHED_MLFQ
+  if (pcb_get_level(cpu) != 2 || pcb_get_epri(cpu) != BAS_PRI - 2 * MLFQ_STEP
+      || sched_quantum(cpu) <= sched_quantum(io))
+    return -3;
+
+  /*
+   * The io one was boosted when it blocked: it goes before the cpu one
+   * when it wakes up
+   */
+  if (pcb_get_level(io) != 0 || pcb_get_epri(io) != BAS_PRI)
+    return -4;
+
+  kwakeup_pcb(io);
+  schedule();
+
+  if (get_current_pcb() != io || rq_first(&rqready) != cpu)
+    return -5;
+
+  /*
+   * The lowest level is the last one
+   */
+  sched_expire(cpu);
+  sched_expire(cpu);
+
+  if (pcb_get_level(cpu) != MLFQ_LEVELS - 1
+      || rq_level(&rqready, pcb_get_epri(cpu))->start != cpu)
+    return -6;
+
+  /*
+   * A change of priority keeps the level
+   */
+  chg_ppri(pcb_get_pid(cpu), MAX_PRI);
+
+  if (pcb_get_epri(cpu) != MAX_PRI - (MLFQ_LEVELS - 1) * MLFQ_STEP
+      || rq_first(&rqready) != cpu)
+    return -7;
+#else
+  /*
+   * Strict priority: nothing moves
+   */
+  if (pcb_get_epri(cpu) != BAS_PRI || pcb_get_epri(io) != BAS_PRI
+      || sched_quantum(cpu) != QUANTUM)
+    return -3;
+#endif
+
+  rq_reset(&rqready);
+  pls_reset(&plsrunning);
+  pls_reset(&plswaiting);
+  set_current_pcb(NULL);
+
+  return OMGROXX;
+}
+
+int32_t
+test_sched_inherit()
+{
+  /*
+   * high waits for low, which waits for a message from blocked. mid is
+   * ready: without inheritance it would run before low.
+   */
+  pcb            *high, *mid, *low, *blocked;
+  char           *names[4] = { "high", "mid", "low", "blocked" };
+  uint32_t        pri[4] = { 40, 20, 5, 1 };
+  uint32_t        i;
+
+  rq_reset(&rqready);
+  pls_reset(&plsrunning);
+  pls_reset(&plswaiting);
+  pls_reset(&plssleeping);
+  set_current_pcb(NULL);
+
+  for (i = 0; i < 4; i++)
+  {
+    pcb_reset(&parray[i]);
+    pcb_set_pid(&parray[i], i + 1);
+    pcb_set_name(&parray[i], names[i]);
+    pcb_set_pri(&parray[i], pri[i]);
+    pcb_set_state(&parray[i], READY);
+    pcb_set_empty(&parray[i], FALSE);
+  }
+
+  high = &parray[0];
+  mid = &parray[1];
+  low = &parray[2];
+  blocked = &parray[3];
+
+  rq_add(&rqready, mid);
+  rq_add(&rqready, low);
+
+  pcb_set_state(blocked, BLOCKED);
+  pls_move_pcb(blocked, &plswaiting);
+
+  pcb_set_state(low, SLEEPING);
+  pls_move_pcb(low, &plssleeping);
+  sched_depend(low, blocked);
+
+  if (pcb_get_epri(blocked) != 5)
+    return -1;
+
+  pcb_set_state(high, WAITING_PCB);
+  pls_move_pcb(high, &plswaiting);
+  sched_depend(high, low);
+
+  /*
+   * The whole chain runs at 40
+   */
+  if (pcb_get_epri(low) != 40 || pcb_get_epri(blocked) != 40
+      || pcb_get_epri(mid) != 20)
+    return -2;
+
+  /*
+   * blocked gets the cpu before mid
+   */
+  kwakeup_pcb(blocked);
+  schedule();
+
+  if (get_current_pcb() != blocked)
+    return -3;
+
+  /*
+   * low gets its message and stops waiting: blocked gives back the
+   * priority
+   */
+  kwakeup_pcb(low);
+
+  if (pcb_get_epri(blocked) != 1 || pcb_get_epri(low) != 40
+      || pcb_get_blocker(low) != NULL)
+    return -4;
+
+  schedule();
+
+  if (get_current_pcb() != low || rq_first(&rqready) != mid)
+    return -5;
+
+  /*
+   * low terminates, high stops to wait
+   */
+  sched_orphan(low);
+
+  if (pcb_get_blocker(high) != NULL || pcb_get_epri(low) != 5)
+    return -6;
+
+  /*
+   * A loop does not hang
+   */
+  sched_depend(mid, high);
+  sched_depend(high, mid);
+  sched_undepend(high);
+  sched_undepend(mid);
+
+  if (pcb_get_epri(high) != 40 || pcb_get_epri(mid) != 20)
+    return -7;
+
+  rq_reset(&rqready);
+  pls_reset(&plsrunning);
+  pls_reset(&plswaiting);
+  pls_reset(&plssleeping);
+  set_current_pcb(NULL);
+
+  return OMGROXX;
+}
+
+int32_t
+test_sched_stat()
+{
+  pcb            *a, *b;
+  schedinfo       si;
+  pcbinfo         pi;
+  uint32_t        i, n;
+
+  rq_reset(&rqready);
+  pls_reset(&plsrunning);
+  pls_reset(&plswaiting);
+  set_current_pcb(NULL);
+  kstat_reset();
+
+  a = &parray[0];
+  pcb_reset(a);
+  pcb_set_pid(a, 1);
+  pcb_set_pri(a, BAS_PRI);
+  pcb_set_empty(a, FALSE);
+  kwakeup_pcb(a);
+
+  b = &parray[1];
+  pcb_reset(b);
+  pcb_set_pid(b, 2);
+  pcb_set_pri(b, BAS_PRI);
+  pcb_set_empty(b, FALSE);
+  kwakeup_pcb(b);
+
+  /*
+   * a runs, is preempted by b, which blocks
+   */
+  schedule();
+#if SCHED_POLICY == SCHED_STRIDE
+  sched_expire(a);
+#endif
+  schedule();
+
+  if (get_current_pcb() != b)
+    return -1;
+
+  pcb_set_state(b, BLOCKED);
+  pls_move_pcb(b, &plswaiting);
+  schedule();
+
+  if (pcb_get_stat(a)->invol_switch != 1 || pcb_get_stat(a)->vol_switch != 0
+      || pcb_get_stat(b)->vol_switch != 1
+      || pcb_get_stat(b)->invol_switch != 0)
+    return -2;
+
+  /*
+   * Still a alone: no switch
+   */
+  schedule();
+
+  if (kstat_get(&si) != OMGROXX || si.switches != 3)
+    return -3;
+
+  /*
+   * One latency per process that got the cpu
+   */
+  for (i = 0, n = 0; i < LAT_BUCKETS; i++)
+    n += si.latency[i];
+
+  if (n != 3)
+    return -4;
+
+  if (get_pinfo(1, &pi) != OMGROXX || pi.invol_switch != 1
+      || pi.epri != BAS_PRI || pi.run_date != pcb_get_stat(a)->run_date)
+    return -5;
+
+  if (kstat_get(NULL) != NULLPTR)
+    return -6;
+
+  /*
+   * Busy and idle times, the parts of ms are kept for the next time
+   */
+  kstat_reset();
+  n = kget_count();
+
+  kstat_cpu(TRUE, n + 10 * timer_msec + timer_msec / 2);
+  kstat_cpu(FALSE, n + 15 * timer_msec);
+  kstat_cpu(FALSE, n + 20 * timer_msec + timer_msec / 2);
+
+  if (kstat_get(&si) != OMGROXX || si.idle_time != 10 || si.busy_time != 10)
+    return -7;
+
+  rq_reset(&rqready);
+  pls_reset(&plsrunning);
+  pls_reset(&plswaiting);
+  set_current_pcb(NULL);
+
+  return OMGROXX;
+}
+
+int32_t
+test_sched_stride()
+{
+  /*
+   * A shell with 3 tickets and a batch job with 7 share the cpu
+   */
+  pcb            *shell, *batch;
+  uint32_t        i, n;
+
+  rq_reset(&rqready);
+  pls_reset(&plsrunning);
+  pls_reset(&plswaiting);
+  set_current_pcb(NULL);
+
+  shell = &parray[0];
+  pcb_reset(shell);
+  pcb_set_pid(shell, 1);
+  pcb_set_pri(shell, MIN_PRI + 2);
+  pcb_set_empty(shell, FALSE);
+  kwakeup_pcb(shell);
+
+  batch = &parray[1];
+  pcb_reset(batch);
+  pcb_set_pid(batch, 2);
+  pcb_set_pri(batch, MIN_PRI + 6);
+  pcb_set_empty(batch, FALSE);
+  kwakeup_pcb(batch);
+
+  schedule();
+
+  for (i = 0, n = 0; i < 100; i++)
+  {
+    if (get_current_pcb() == shell)
+      n++;
+
+    sched_expire(get_current_pcb());
+    schedule();
+  }
+
+  if (n < 29 || n > 31)
+    return -1;
+
+  /*
+   * A process waking up does not preempt, and does not get back the time
+   * it slept
+   */
+  if (get_current_pcb() == shell)
+  {
+    sched_expire(shell);
+    schedule();
+  }
+
+  pcb_set_state(shell, BLOCKED);
+  pls_move_pcb(shell, &plswaiting);
+
+  for (i = 0; i < 50; i++)
+  {
+    sched_expire(batch);
+    schedule();
+  }
+
+  kwakeup_pcb(shell);
+
+  if (sched_preempt(batch, shell) || get_current_pcb() != batch)
+    return -2;
+
+  for (i = 0, n = 0; i < 10; i++)
+  {
+    if (get_current_pcb() == shell)
+      n++;
+
+    sched_expire(get_current_pcb());
+    schedule();
+  }
+
+  if (n > 4)
+    return -3;
+
+  rq_reset(&rqready);
+  pls_reset(&plsrunning);
+  pls_reset(&plswaiting);
+  set_current_pcb(NULL);
+
+  return OMGROXX;
+}
@@ -8,6 +8,7 @@
 #include <string.h>
 #include "../kernel/kprocess.h"
 #include "../kernel/ksleep.h"
+#include "../kernel/ktimer.h"
 
 int32_t         test_process_sleep();
 
@@ -31,8 +32,9 @@ test_ksleep()
 
   kprintln("--------------TEST MODULE KSLEEP END---------------\n");
 
-  pls_reset(&plsready);
+  rq_reset(&rqready);
   pls_reset(&plswaiting);
+  pls_reset(&plssleeping);
 
 }
 
@@ -41,35 +43,53 @@ test_process_sleep()
 {
   /*
    * We set the following list :
-   * plsready :
+   * run queue :
    * Name       Pri       State     time to sleep
    * Pri42      42        READY     0
    * Pri2       2         READY     0
    *
    * plswaiting:
-   * PRI41      41        SLEEP     QUANTUM - 1
-   * PRI32      32        SLEEP     2*QUANTUM
    * PRI21      21        BLOCK     0
-   * PRI12      12        SLEEP     3*QUANTUM
    *
-   * After the test the list will look like this:
-   * plsready :
+   * plssleeping (added in this order):
+   * PRI32      32        SLEEP     now + 2*QUANTUM
+   * PRI12      12        SLEEP     now + 3*QUANTUM (count wrapped)
+   * PRI41      41        SLEEP     now + QUANTUM - 1
+   *
+   * Then one QUANTUM pass, after the test the list will look like this:
+   * run queue :
    * Name       Pri       State     time to sleep
    * Pri42      42        READY     0
    * PRI41      41        READY     0
    * Pri2       2         READY     0
    *
    * plswaiting:
-   * PRI32      32        SLEEP     QUANTUM
    * PRI21      21        BLOCK     0
-   * PRI12      12        SLEEP     2*QUANTUM
+   *
+   * plssleeping:
+   * PRI32      32        SLEEP     now + 2*QUANTUM
+   * PRI12      12        SLEEP     now + 3*QUANTUM
    */
 
   pcb            *p;
-  pcb             parray[MAXPCB];
+  static pcb      parray[MAXPCB];
+  uint32_t        now, date;
 
-  pls_reset(&plsready);
+  /*
+   * Close to the wrap of count, to check the dates comparison
+   */
+  now = 0xFFFFFFFF - QUANTUM;
+
+  rq_reset(&rqready);
   pls_reset(&plswaiting);
+  pls_reset(&plssleeping);
+
+  /*
+   * Nobody sleeps
+   */
+  if (sleep_next(&date))
+    return -1;
+
   /*
    * First populate the list
    */
@@ -79,7 +99,7 @@ test_process_sleep()
   pcb_set_pri(p, 42);
   pcb_set_state(p, READY);
   pcb_set_empty(p, FALSE);
-  pls_add(&plsready, p);
+  rq_add(&rqready, p);
 
   p = &parray[1];
   pcb_reset(p);
@@ -87,14 +107,13 @@ test_process_sleep()
   pcb_set_pri(p, 2);
   pcb_set_state(p, READY);
   pcb_set_empty(p, FALSE);
-  pls_add(&plsready, p);
+  rq_add(&rqready, p);
 
   p = &parray[2];
   pcb_reset(p);
-  pcb_set_name(p, "pri41");
-  pcb_set_pri(p, 41);
-  pcb_set_state(p, SLEEPING);
-  pcb_set_sleep(p, QUANTUM - 1);
+  pcb_set_name(p, "pri21");
+  pcb_set_pri(p, 21);
+  pcb_set_state(p, BLOCKED);
   pcb_set_empty(p, FALSE);
   pls_add(&plswaiting, p);
 
@@ -102,66 +121,94 @@ test_process_sleep()
   pcb_reset(p);
   pcb_set_name(p, "pri32");
   pcb_set_pri(p, 32);
-  pcb_set_state(p, SLEEPING);
-  pcb_set_sleep(p, 2 * QUANTUM);
   pcb_set_empty(p, FALSE);
-  pls_add(&plswaiting, p);
+  sleep_add(p, now + 2 * QUANTUM);
 
   p = &parray[4];
   pcb_reset(p);
-  pcb_set_name(p, "pri21");
-  pcb_set_pri(p, 21);
-  pcb_set_state(p, BLOCKED);
+  pcb_set_name(p, "pri12");
+  pcb_set_pri(p, 12);
   pcb_set_empty(p, FALSE);
-  pls_add(&plswaiting, p);
+  sleep_add(p, now + 3 * QUANTUM);
 
   p = &parray[5];
   pcb_reset(p);
-  pcb_set_name(p, "pri12");
-  pcb_set_pri(p, 12);
-  pcb_set_state(p, SLEEPING);
-  pcb_set_sleep(p, 3 * QUANTUM);
+  pcb_set_name(p, "pri41");
+  pcb_set_pri(p, 41);
   pcb_set_empty(p, FALSE);
-  pls_add(&plswaiting, p);
+  sleep_add(p, now + QUANTUM - 1);
+
+  /*
+   * The list must be sorted by date
+   */
+  if (plssleeping.start != &parray[5]
+      || pcb_get_next(&parray[5]) != &parray[3]
+      || plssleeping.end != &parray[4]
+      || pcb_get_state(&parray[4]) != SLEEPING)
+    return -2;
+
+  if (!sleep_next(&date) || date != now + QUANTUM - 1)
+    return -3;
+
+  /*
+   * Too early, nobody wakes up
+   */
+  process_sleep(now);
+
+  if (plssleeping.length != 3)
+    return -4;
 
   /*
    * Ok, fire in the hole!
    */
-  process_sleep();
+  process_sleep(now + QUANTUM);
 
   /*
    * Now the long and painfull check
    */
 
-  if (strcmp(pcb_get_name(plsready.start), "pri42") != 0)
-    return -1;
+  if (strcmp(pcb_get_name(rq_first(&rqready)), "pri42") != 0)
+    return -5;
 
-  p = pcb_get_next(plsready.start);
+  p = rq_level(&rqready, 41)->start;
 
   if (strcmp(pcb_get_name(p), "pri41") != 0
       || pcb_get_sleep(p) != 0 || pcb_get_state(p) != READY)
-    return -2;
+    return -6;
 
-  p = pcb_get_next(p);
+  p = rq_level(&rqready, 2)->start;
 
   if (strcmp(pcb_get_name(p), "pri2") != 0)
-    return -3;
+    return -7;
 
-  if (strcmp(pcb_get_name(plswaiting.start), "pri32") != 0
-      || pcb_get_sleep(plswaiting.start) != QUANTUM
-      || pcb_get_state(plswaiting.start) != SLEEPING)
-    return -4;
+  if (plswaiting.length != 1
+      || pcb_get_state(plswaiting.start) != BLOCKED)
+    return -8;
 
-  p = pcb_get_next(plswaiting.start);
+  p = plssleeping.start;
 
-  if (strcmp(pcb_get_name(p), "pri21") != 0)
-    return -5;
+  if (strcmp(pcb_get_name(p), "pri32") != 0
+      || pcb_get_sleep(p) != now + 2 * QUANTUM
+      || pcb_get_state(p) != SLEEPING)
+    return -9;
 
   p = pcb_get_next(p);
 
   if (strcmp(pcb_get_name(p), "pri12") != 0
-      || pcb_get_sleep(p) != 2 * QUANTUM || pcb_get_state(p) != SLEEPING)
-    return -6;
+      || pcb_get_sleep(p) != now + 3 * QUANTUM
+      || pcb_get_state(p) != SLEEPING)
+    return -10;
+
+  if (!sleep_next(&date) || date != now + 2 * QUANTUM)
+    return -11;
+
+  /*
+   * After the wrap of count, everybody wakes up at once
+   */
+  process_sleep(now + 4 * QUANTUM);
+
+  if (plssleeping.length != 0 || rq_level(&rqready, 12)->start != p)
+    return -12;
 
   return OMGROXX;
 
@@ -0,0 +1,217 @@
+/**
+ * @file test_kstack.c
+ * @brief test the buddy allocator of the stacks
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include "../kernel/kstack.h"
+
+int32_t         test_kstack_size();
+int32_t         test_kstack_split();
+int32_t         test_kstack_merge();
+int32_t         test_kstack_peak();
+
+void
+test_kstack()
+{
+  int             e;
+  char            c;
+
+  kprintln("--------------TEST MODULE KSTACK BEGIN------------");
+
+  kprint("Test kstack_size\t\t\t\t");
+  e = test_kstack_size();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, &c));
+  }
+
+  kprint("Test kstack_alloc\t\t\t\t");
+  e = test_kstack_split();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, &c));
+  }
+
+  kprint("Test kstack_free\t\t\t\t");
+  e = test_kstack_merge();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, &c));
+  }
+
+#if STACK_CHECK
+  kprint("Test kstack_peak\t\t\t\t");
+  e = test_kstack_peak();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, &c));
+  }
+#endif
+
+  kprintln("--------------TEST MODULE KSTACK END--------------\n");
+
+  kstack_reset();
+}
+
+int32_t
+test_kstack_size()
+{
+  if (kstack_size(0) != STACK_DEFAULT)
+    return -1;
+
+  if (kstack_size(1) != STACK_MIN)
+    return -2;
+
+  if (kstack_size(STACK_MIN + 1) != 2 * STACK_MIN)
+    return -3;
+
+  if (kstack_size(STACK_MAX) != STACK_MAX)
+    return -4;
+
+  if (kstack_size(STACK_MAX + 1) != 0)
+    return -5;
+
+  return OMGROXX;
+}
+
+/*
+ * Small stacks are split from one big block, next to each other
+ */
+int32_t
+test_kstack_split()
+{
+  uint32_t       *a, *b, *c;
+
+  kstack_reset();
+
+  a = kstack_alloc(STACK_MIN);
+  b = kstack_alloc(STACK_MIN);
+  c = kstack_alloc(2 * STACK_MIN);
+
+  if (a == NULL || b == NULL || c == NULL)
+    return -1;
+
+  if (b != a + STACK_MIN || c != a + 2 * STACK_MIN)
+    return -2;
+
+  if (kstack_free_words() != STACK_WORDS - 4 * STACK_MIN)
+    return -3;
+
+  /*
+   * Not a block size
+   */
+  if (kstack_alloc(STACK_MIN + 1) != NULL)
+    return -4;
+
+  return OMGROXX;
+}
+
+/*
+ * The freed blocks are merged back: the whole region can be allocated in
+ * blocks of STACK_MAX again
+ */
+int32_t
+test_kstack_merge()
+{
+  uint32_t       *a, *b, *c;
+  uint32_t        i;
+
+  kstack_reset();
+
+  a = kstack_alloc(STACK_MIN);
+  b = kstack_alloc(STACK_MIN);
+  c = kstack_alloc(4 * STACK_MIN);
+
+  /*
+   * Wrong size, wrong address, twice
+   */
+  if (kstack_free(a, 2 * STACK_MIN) != INVARG)
+    return -1;
+
+  if (kstack_free(a + 1, STACK_MIN) != INVARG)
+    return -2;
+
+  if (kstack_free(b, STACK_MIN) != OMGROXX)
+    return -3;
+
+  if (kstack_free(b, STACK_MIN) != INVARG)
+    return -4;
+
+  /*
+   * b is merged with a once a is free
+   */
+  kstack_free(a, STACK_MIN);
+
+  if (kstack_alloc(2 * STACK_MIN) != a)
+    return -5;
+
+  kstack_free(a, 2 * STACK_MIN);
+  kstack_free(c, 4 * STACK_MIN);
+
+  if (kstack_free_words() != STACK_WORDS)
+    return -6;
+
+  for (i = 0; i < STACK_WORDS / STACK_MAX; i++)
+    if (kstack_alloc(STACK_MAX) == NULL)
+      return -7;
+
+  if (kstack_alloc(STACK_MIN) != NULL)
+    return -8;
+
+  return OMGROXX;
+}
+
+/*
+ * The peak is the deepest word changed, the canary catches an overflow
+ */
+int32_t
+test_kstack_peak()
+{
+  uint32_t       *a;
+
+  kstack_reset();
+
+  a = kstack_alloc(STACK_MIN);
+  kstack_fill(a, STACK_MIN);
+
+  if (!kstack_ok(a))
+    return -1;
+
+  if (kstack_peak(a, STACK_MIN) != 0)
+    return -2;
+
+  a[STACK_MIN - 1] = 0;
+  a[STACK_MIN - 10] = 0;
+
+  if (kstack_peak(a, STACK_MIN) != 10)
+    return -3;
+
+  /*
+   * All the stack used: the canary is still there
+   */
+  a[1] = 0;
+
+  if (kstack_peak(a, STACK_MIN) != STACK_MIN - 1 || !kstack_ok(a))
+    return -4;
+
+  a[0] = 0;
+
+  if (kstack_ok(a))
+    return -5;
+
+  return OMGROXX;
+}
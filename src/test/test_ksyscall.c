@@ -0,0 +1,866 @@
+/**
+ * @file test_ksyscall.c
+ * @brief Test the syscalls, and measure the cost of a round trip
+ */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include "../kernel/kernel.h"
+#include "../kernel/kinout.h"
+#include "../kernel/kprocess.h"
+#include "../kernel/ksyscall.h"
+#include "../kernel/kprocess_list.h"
+#include "../kernel/kscheduler.h"
+#include "../kernel/ksleep.h"
+#include "../kernel/ktimer.h"
+#include "../kernel/kstack.h"
+
+/**
+ * @brief Number of syscalls of the benchmark
+ */
+#define BENCH_SYSCALLS 1000
+
+int32_t         test_syscall_getpid();
+int32_t         test_syscall_getpsinfo();
+int32_t         test_syscall_fourchette_args();
+int32_t         test_syscall_fourchette_many();
+int32_t         test_syscall_waitany();
+int32_t         test_syscall_recv();
+int32_t         test_syscall_call();
+int32_t         test_syscall_stackovf();
+int32_t         test_syscall_preempt();
+void            bench_ksyscall();
+
+static pcb      sc_pcb;         // The process doing the syscalls
+
+void
+test_ksyscall()
+{
+  int             e;
+  char            c[12];
+
+  kprintln("-------------TEST MODULE SYSCALL BEGIN------------");
+
+  kprint("Test GETPID\t\t\t\t\t");
+  e = test_syscall_getpid();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, c));
+  }
+
+  kprint("Test GETPSINFO\t\t\t\t\t");
+  e = test_syscall_getpsinfo();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, c));
+  }
+
+  kprint("Test FOURCHETTEARGS\t\t\t\t");
+  e = test_syscall_fourchette_args();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, c));
+  }
+
+  kprint("Test FOURCHETTEMANY\t\t\t\t");
+  e = test_syscall_fourchette_many();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, c));
+  }
+
+  kprint("Test WAITANY\t\t\t\t\t");
+  e = test_syscall_waitany();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, c));
+  }
+
+  kprint("Test RECV\t\t\t\t\t");
+  e = test_syscall_recv();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, c));
+  }
+
+  kprint("Test CALL\t\t\t\t\t");
+  e = test_syscall_call();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, c));
+  }
+
+  /*
+   * The stride scheduler lets the running process end its time slice
+   */
+#if SCHED_POLICY != SCHED_STRIDE
+  kprint("Test PREEMPT\t\t\t\t\t");
+  e = test_syscall_preempt();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, c));
+  }
+#endif
+
+#if STACK_CHECK
+  kprint("Test STACKOVF\t\t\t\t\t");
+  e = test_syscall_stackovf();
+  if (e == OMGROXX)
+    kprintln("OK");
+  else
+  {
+    kprint("FAIL: ");
+    kprintln(itos(e, c));
+  }
+#endif
+
+  bench_ksyscall();
+
+  kprintln("-------------TEST MODULE SYSCALL END--------------\n");
+}
+
+/*
+ * Make sc_pcb the running process
+ */
+static void
+sc_test_run()
+{
+  rq_reset(&rqready);
+  pls_reset(&plsrunning);
+
+  pcb_reset(&sc_pcb);
+  pcb_set_pid(&sc_pcb, 7);
+  pcb_set_pri(&sc_pcb, BAS_PRI);
+  pcb_set_state(&sc_pcb, RUNNING);
+  pcb_set_empty(&sc_pcb, FALSE);
+  pls_move_pcb(&sc_pcb, &plsrunning);
+  set_current_pcb(&sc_pcb);
+}
+
+int32_t
+test_syscall_getpid()
+{
+  uint32_t        i;
+
+  sc_test_run();
+
+  /*
+   * The result comes back, and the process keeps running
+   */
+  for (i = 0; i < 3; i++)
+    if (syscall_none(GETPID) != 7)
+      return -1;
+
+  if (get_current_pcb() != &sc_pcb || pcb_get_state(&sc_pcb) != RUNNING)
+    return -2;
+
+  pls_reset(&plsrunning);
+  set_current_pcb(NULL);
+
+  return OMGROXX;
+}
+
+/*
+ * No process at all, like at boot
+ */
+static void
+sc_boot()
+{
+  rq_reset(&rqready);
+  pls_reset(&plsrunning);
+  pls_reset(&plswaiting);
+  pls_reset(&plssleeping);
+  pls_reset(&plsterminate);
+  reset_next_pid();
+  reset_used_stack();
+  init_mem();
+  set_current_pcb(NULL);
+}
+
+/*
+ * Processes of pmem are copied in the order of pmem, up to the size of the
+ * array
+ */
+int32_t
+test_syscall_getpsinfo()
+{
+  static psinfo   tab[MAXPCB];
+  int32_t         a, b;
+
+  sc_boot();
+
+  if (get_all_psinfo(tab, MAXPCB) != 0)
+    return -1;
+
+  a = create_proc("increment", BAS_PRI, 0, NULL);
+  b = create_proc("fibonacci", BAS_PRI + 1, 0, NULL);
+
+  if (get_all_psinfo(NULL, MAXPCB) != NULLPTR)
+    return -2;
+
+  if (get_all_psinfo(tab, MAXPCB) != 2)
+    return -3;
+
+  if (tab[0].pid != a || strcmp(tab[0].name, "increment") != 0
+      || tab[0].state != READY || tab[0].pri != BAS_PRI
+      || tab[0].nb_msg != 0)
+    return -4;
+
+  if (tab[1].pid != b || strcmp(tab[1].name, "fibonacci") != 0
+      || tab[1].pri != BAS_PRI + 1)
+    return -5;
+
+  /*
+   * The array is too small
+   */
+  tab[1].pid = -1;
+
+  if (get_all_psinfo(tab, 1) != 1 || tab[0].pid != a || tab[1].pid != -1)
+    return -6;
+
+  sc_boot();
+
+  return OMGROXX;
+}
+
+/*
+ * The block of arguments is copied at the top of the stack, the arrays of
+ * ARG_SIZE chars are packed the same way
+ */
+int32_t
+test_syscall_fourchette_args()
+{
+  argblock        args;
+  char            params[3][ARG_SIZE];
+  char          **argv;
+  int32_t         a;
+  pcb            *p;
+
+  sc_boot();
+
+  args_init(&args, "increment");
+  args_add(&args, "12");
+  args_add(&args, "");
+
+  a = create_proc_args(BAS_PRI, &args);
+  if (a < 0)
+    return -1;
+
+  /*
+   * The process has its own copy
+   */
+  args.data[1] = 'X';
+
+  p = search_all_list(a);
+  argv = (char **) p->registers.a_reg[1];
+
+  if (p->registers.a_reg[0] != 3 || strcmp(get_arg(argv, 0), "increment") != 0
+      || strcmp(get_arg(argv, 1), "12") != 0
+      || strcmp(get_arg(argv, 2), "") != 0
+      || strcmp(get_arg(argv, 3), "") != 0)
+    return -2;
+
+  if (pcb_get_sp(p) != (((uint32_t) argv - 16) & ~7)
+      || (uint32_t *) argv + (args.size + 3) / 4
+      != pcb_get_stack(p) + pcb_get_stack_size(p))
+    return -3;
+
+  /*
+   * The process spills a0 and a1 above its sp, like an o32 function at -O0:
+   * the block stays whole
+   */
+  ((uint32_t *) pcb_get_sp(p))[0] = p->registers.a_reg[0];
+  ((uint32_t *) pcb_get_sp(p))[1] = p->registers.a_reg[1];
+  ((uint32_t *) pcb_get_sp(p))[2] = 0;
+  ((uint32_t *) pcb_get_sp(p))[3] = 0;
+
+  if (((argblock *) argv)->size != args.size
+      || strcmp(get_arg(argv, 0), "increment") != 0
+      || strcmp(get_arg(argv, 1), "12") != 0)
+    return -10;
+
+  strcpy("increment", params[0]);
+  strcpy("12", params[1]);
+  strcpy("", params[2]);
+
+  p = search_all_list(create_proc("increment", BAS_PRI, 2, (char **) params));
+  if (p == NULL)
+    return -4;
+
+  argv = (char **) p->registers.a_reg[1];
+
+  if (p->registers.a_reg[0] != 3 || ((argblock *) argv)->size != args.size
+      || strcmp(get_arg(argv, 1), "12") != 0)
+    return -5;
+
+  /*
+   * A name out of the block, an unknown program
+   */
+  args.size = ARG_HEADER + 1;
+
+  if (create_proc_args(BAS_PRI, &args) != INVARG)
+    return -6;
+
+  args_init(&args, "nope");
+
+  if (create_proc_args(BAS_PRI, &args) != INVARG)
+    return -7;
+
+  /*
+   * A full block
+   */
+  args_init(&args, "increment");
+  while (args_add(&args, "0123456789") == OMGROXX);
+
+  if (args.size > ARG_BLOCK || args.size + 12 <= ARG_BLOCK)
+    return -8;
+
+  if (create_proc_args(BAS_PRI, &args) < 0)
+    return -9;
+
+  sc_boot();
+
+  return OMGROXX;
+}
+
+/*
+ * The processes get the blocks in turn, the creation stops when there is no
+ * pcb left
+ */
+int32_t
+test_syscall_fourchette_many()
+{
+  static int      pids[MAXPCB + 1];
+  argblock        args[2];
+  spawninfo       s;
+  pcb            *p;
+  int32_t         i;
+
+  sc_boot();
+
+  args_init(&args[0], "increment");
+  args_add(&args[0], "x0");
+  args_init(&args[1], "increment");
+  args_add(&args[1], "x1");
+
+  s.name = "increment";
+  s.prio = BAS_PRI;
+  s.n = 3;
+  s.args = args;
+  s.nargs = 2;
+  s.pids = pids;
+
+  if (create_proc_many(&s) != 3 || pids[0] == pids[1] || pids[1] == pids[2])
+    return -1;
+
+  for (i = 0; i < 3; i++)
+  {
+    p = search_all_list(pids[i]);
+
+    if (p == NULL
+        || strcmp(get_arg((char **) p->registers.a_reg[1], 1),
+                  i % 2 ? "x1" : "x0") != 0)
+      return -2;
+  }
+
+  /*
+   * Nothing is created with a bad block or an unknown program
+   */
+  sc_boot();
+
+  args[1].size = ARG_BLOCK + 4;
+
+  if (create_proc_many(&s) != INVARG)
+    return -3;
+
+  s.nargs = 0;
+  s.name = "nope";
+
+  if (create_proc_many(&s) != INVARG)
+    return -4;
+
+  s.name = "increment";
+  s.n = MAXPCB + 1;
+
+  if (create_proc_many(&s) != MAXPCB || pids[MAXPCB] != OUTOMEM)
+    return -5;
+
+  if (search_all_list(pids[0])->registers.a_reg[0] != 0)
+    return -6;
+
+  sc_boot();
+
+  return OMGROXX;
+}
+
+/*
+ * A zombie child is taken at once. Otherwise the parent blocks once, and the
+ * child that exits gives it its pid and its status: v0 is set, the child is
+ * removed.
+ */
+int32_t
+test_syscall_waitany()
+{
+  int32_t         status, a, b, set[2];
+  pcb            *parent;
+
+  sc_boot();
+
+  /*
+   * The parent is also init
+   */
+  create_proc("increment", BAS_PRI, 0, NULL);
+  schedule();
+  parent = get_current_pcb();
+
+  if (syscall_three(0, 0, (int32_t) & status, WAITANY) != NOTFOUND)
+    return -1;
+
+  a = create_proc("increment", BAS_PRI, 0, NULL);
+  b = create_proc("increment", BAS_PRI, 0, NULL);
+
+  set[0] = 999;
+  if (syscall_three((int32_t) set, 1, (int32_t) & status, WAITANY)
+      != NOTFOUND)
+    return -2;
+
+  kkill(a);
+  status = 0;
+
+  if (syscall_three(0, 0, (int32_t) & status, WAITANY) != a
+      || status != KILLED || search_all_list(a) != NULL)
+    return -3;
+
+  /*
+   * b runs while the parent waits, and kills itself
+   */
+  syscall_three(0, 0, (int32_t) & status, WAITANY);
+
+  if (pcb_get_state(parent) != WAITING_PCB
+      || get_current_pcb() != search_all_list(b))
+    return -4;
+
+  status = 0;
+  kkill(b);
+
+  if (get_current_pcb() != parent || parent->registers.v_reg[0] != b
+      || status != KILLED || search_all_list(b) != NULL)
+    return -5;
+
+  /*
+   * A child out of the set does not wake the parent up
+   */
+  a = create_proc("increment", BAS_PRI, 0, NULL);
+  b = create_proc("increment", BAS_PRI, 0, NULL);
+  set[0] = b;
+
+  syscall_three((int32_t) set, 1, (int32_t) & status, WAITANY);
+  kkill(a);
+
+  if (pcb_get_state(parent) != WAITING_PCB
+      || pcb_get_state(search_all_list(a)) != OMG_ZOMBIE)
+    return -6;
+
+  kkill(b);
+
+  if (get_current_pcb() != parent || parent->registers.v_reg[0] != b)
+    return -7;
+
+  /*
+   * The wait for a pid gets the status the same way
+   */
+  if (waitfor(a, &status) != OMGROXX)
+    return -8;
+
+  a = create_proc("increment", BAS_PRI, 0, NULL);
+  status = 0;
+  waitfor(a, &status);
+  kkill(a);
+
+  if (parent->registers.v_reg[0] != OMGROXX || status != KILLED
+      || search_all_list(a) != NULL)
+    return -9;
+
+  sc_boot();
+
+  return OMGROXX;
+}
+
+/*
+ * The receiver blocks in the kernel, the sender gives it the message and
+ * its pid in v0. The timeout wakes it up with NOTFOUND.
+ */
+int32_t
+test_syscall_recv()
+{
+  int32_t         a, b, data;
+  char            str[8];
+  pcb            *p;
+  msg_arg         s = { (void *) 42, INT_T, 0, MIN_MPRI, 0, FNONE };
+  msg_arg         r = { &data, INT_T, 0, MIN_MPRI, 0, FPID };
+  msg_arg         rs = { str, CHAR_PTR, 0, MIN_MPRI, 1, FTYPE };
+
+  sc_boot();
+
+  a = create_proc("increment", BAS_PRI, 0, NULL);
+  b = create_proc("increment", BAS_PRI, 0, NULL);
+  schedule();
+
+  p = get_current_pcb();
+  if (pcb_get_pid(p) != a)
+    return -1;
+
+  s.pid = a;
+  r.pid = b;
+  data = 0;
+
+  /*
+   * Nothing there: a waits, b runs
+   */
+  syscall_one((int32_t) & r, RECV);
+
+  if (pcb_get_state(p) != WAITING_MSG || pcb_get_head(p) != &plswaiting
+      || pcb_get_pid(get_current_pcb()) != b)
+    return -2;
+
+  syscall_one((int32_t) & s, SEND);
+
+  if (pcb_get_state(p) != READY || p->registers.v_reg[0] != b || data != 42
+      || p->messages.length != 0 || p->messages.status != NO_WAIT
+      || p->messages.arg != NULL)
+    return -3;
+
+  /*
+   * a does not wait any more: the next one is in the mailbox
+   */
+  s.data = (void *) 7;
+  syscall_one((int32_t) & s, SEND);
+
+  if (p->messages.length != 1)
+    return -4;
+
+  sched_expire(get_current_pcb());
+  schedule();
+
+  if (get_current_pcb() != p || syscall_one((int32_t) & r, RECV) != b
+      || data != 7)
+    return -5;
+
+  /*
+   * A message out of the filter does not wake a up, the timeout does
+   */
+  syscall_one((int32_t) & rs, RECV);
+
+  if (pcb_get_state(p) != WAITING_MSG || pcb_get_head(p) != &plssleeping)
+    return -6;
+
+  syscall_one((int32_t) & s, SEND);
+
+  if (pcb_get_state(p) != WAITING_MSG || p->messages.length != 1)
+    return -7;
+
+  process_sleep(ktimer_date(2 * timer_msec));
+
+  if (pcb_get_state(p) != READY || p->registers.v_reg[0] != NOTFOUND
+      || p->messages.status != NO_WAIT || p->messages.arg != NULL)
+    return -8;
+
+  sc_boot();
+
+  return OMGROXX;
+}
+
+/*
+ * The running processes use their time slice until p runs, with
+ * SCHED_STRIDE init may come before
+ */
+static bool
+sc_run(pcb * p)
+{
+  uint32_t        i;
+
+  for (i = 0; i < 4 && get_current_pcb() != p; i++)
+  {
+    sched_expire(get_current_pcb());
+    schedule();
+  }
+
+  return get_current_pcb() == p;
+}
+
+/*
+ * The server and its client give the cpu to each other without the run
+ * queue. A call to a busy server waits for it, a call to a terminated
+ * server ends with UNKNPID.
+ */
+int32_t
+test_syscall_call()
+{
+  int32_t         a, b, req, rep;
+  pcb            *p, *q;
+
+  sc_boot();
+
+  create_proc("increment", MIN_PRI, 0, NULL);
+  a = create_proc("increment", BAS_PRI, 0, NULL);
+  b = create_proc("increment", BAS_PRI, 0, NULL);
+  schedule();
+
+  p = search_all_list(a);
+  q = search_all_list(b);
+  if (!sc_run(p))
+    return -1;
+
+  if (syscall_three(a, 1, (int32_t) & rep, CALL) != INVARG
+      || syscall_three(MAXPCB + 1, 1, (int32_t) & rep, CALL) != UNKNPID
+      || syscall_three(b, 1, (int32_t) & req, REPLYWAIT) != UNKNPID)
+    return -2;
+
+  /*
+   * No call yet: a waits, b runs and calls, a runs at once
+   */
+  syscall_three(-1, 0, (int32_t) & req, REPLYWAIT);
+
+  if (pcb_get_state(p) != WAITING_CALL || get_current_pcb() != q)
+    return -3;
+
+  syscall_three(a, 5, (int32_t) & rep, CALL);
+
+  if (get_current_pcb() != p || p->registers.v_reg[0] != b || req != 5
+      || pcb_get_state(q) != WAITING_REPLY || pcb_get_blocker(q) != p
+      || rq_first(&rqready) == p || rq_first(&rqready) == q)
+    return -4;
+
+  /*
+   * The reply goes back to b at once
+   */
+  syscall_three(b, 6, (int32_t) & req, REPLYWAIT);
+
+  if (get_current_pcb() != q || q->registers.v_reg[0] != OMGROXX
+      || rep != 6 || pcb_get_state(p) != WAITING_CALL
+      || pcb_get_blocker(q) != NULL)
+    return -5;
+
+  /*
+   * a only replies and keeps the cpu, b calls a busy server and waits
+   */
+  syscall_three(a, 7, (int32_t) & rep, CALL);
+
+  if (syscall_three(b, 8, 0, REPLYWAIT) != OMGROXX || get_current_pcb() != p
+      || pcb_get_state(q) != READY || rep != 8)
+    return -6;
+
+  if (!sc_run(q))
+    return -7;
+
+  syscall_three(a, 9, (int32_t) & rep, CALL);
+
+  if (get_current_pcb() != p || pcb_get_state(q) != CALLING)
+    return -8;
+
+  if (syscall_three(-1, 0, (int32_t) & req, REPLYWAIT) != b || req != 9
+      || get_current_pcb() != p || pcb_get_state(q) != WAITING_REPLY)
+    return -9;
+
+  /*
+   * a terminates without a reply
+   */
+  syscall_one(0, EXIT);
+
+  if (pcb_get_state(q) != READY && get_current_pcb() != q)
+    return -10;
+
+  if (q->registers.v_reg[0] != UNKNPID || rep != 8)
+    return -11;
+
+  sc_boot();
+
+  return OMGROXX;
+}
+
+/*
+ * A syscall that wakes up a more prioritary process, or that makes the
+ * caller give back a lent priority, gives the cpu at once: the timer is not
+ * needed
+ */
+int32_t
+test_syscall_preempt()
+{
+  int32_t         a, b, c, data;
+  pcb            *p, *q, *r;
+  msg_arg         s = { (void *) 42, INT_T, 0, MIN_MPRI, 0, FNONE };
+  msg_arg         m = { &data, INT_T, 0, MIN_MPRI, 0, FPID };
+
+  sc_boot();
+
+  create_proc("increment", MIN_PRI, 0, NULL);
+  a = create_proc("increment", BAS_PRI + 2, 0, NULL);
+  b = create_proc("increment", BAS_PRI, 0, NULL);
+  c = create_proc("increment", BAS_PRI + 1, 0, NULL);
+  schedule();
+
+  p = search_all_list(a);
+  q = search_all_list(b);
+  r = search_all_list(c);
+  if (get_current_pcb() != p)
+    return -1;
+
+  /*
+   * a waits for b, and lends it its priority: b runs before c
+   */
+  s.pid = a;
+  m.pid = b;
+  syscall_one((int32_t) & m, RECV);
+
+  if (get_current_pcb() != q || pcb_get_epri(q) <= pcb_get_epri(r))
+    return -2;
+
+  /*
+   * b wakes a up: a runs at once
+   */
+  syscall_one((int32_t) & s, SEND);
+
+  if (get_current_pcb() != p || p->registers.v_reg[0] != b || data != 42
+      || pcb_get_state(q) != READY)
+    return -3;
+
+  syscall_one((int32_t) & m, RECV);
+
+  if (get_current_pcb() != q)
+    return -4;
+
+  /*
+   * a is killed: b gives back its priority, and c runs at once
+   */
+  syscall_one(a, KILL);
+
+  if (get_current_pcb() != r || pcb_get_state(q) != READY)
+    return -5;
+
+  sc_boot();
+
+  return OMGROXX;
+}
+
+/*
+ * The canary is checked whenever a process leaves the cpu, not only when
+ * it is preempted: a process that blocks, or that gives the cpu straight
+ * to its client, is killed too if it overflowed its stack
+ */
+int32_t
+test_syscall_stackovf()
+{
+  int32_t         a, b, c, data, req, rep;
+  pcb            *p, *q, *r;
+  msg_arg         m = { &data, INT_T, 0, MIN_MPRI, 0, FPID };
+
+  sc_boot();
+
+  create_proc("increment", MIN_PRI, 0, NULL);
+  a = create_proc("increment", BAS_PRI, 0, NULL);
+  b = create_proc("increment", BAS_PRI, 0, NULL);
+  c = create_proc("increment", BAS_PRI, 0, NULL);
+  schedule();
+
+  p = search_all_list(a);
+  q = search_all_list(b);
+  r = search_all_list(c);
+  if (!sc_run(p))
+    return -1;
+
+  /*
+   * a blocks on a message
+   */
+  m.pid = b;
+  pcb_get_stack(p)[0] = 0;
+  syscall_one((int32_t) & m, RECV);
+
+  if (pcb_get_state(p) != OMG_ZOMBIE || pcb_get_ret(p) != STACKOVF
+      || get_current_pcb() == p)
+    return -2;
+
+  /*
+   * c replies to b and would give it the cpu at once
+   */
+  if (!sc_run(r))
+    return -3;
+
+  syscall_three(-1, 0, (int32_t) & req, REPLYWAIT);
+
+  if (!sc_run(q))
+    return -4;
+
+  syscall_three(c, 5, (int32_t) & rep, CALL);
+
+  if (get_current_pcb() != r || req != 5)
+    return -5;
+
+  pcb_get_stack(r)[0] = 0;
+  syscall_three(b, 6, (int32_t) & req, REPLYWAIT);
+
+  if (pcb_get_state(r) != OMG_ZOMBIE || pcb_get_ret(r) != STACKOVF
+      || q->registers.v_reg[0] != OMGROXX || rep != 6 || !sc_run(q))
+    return -6;
+
+  sc_boot();
+
+  return OMGROXX;
+}
+
+/**
+ * Round trips of GETPID, the cheapest syscall: on the target it is the cost
+ * of the exception path. Compare with a build with KCONFIG=-DSYSCALL_FAST=0.
+ * The figure is in ticks of the count register, which runs at half the CPU
+ * clock: one tick is two cycles. The host build calls syscall_handler
+ * directly and never goes through exception.S, so its figure says nothing
+ * about the fast path.
+ */
+void
+bench_ksyscall()
+{
+  uint32_t        i, t;
+  char            c[12];
+
+  sc_test_run();
+
+  t = kget_count();
+  for (i = 0; i < BENCH_SYSCALLS; i++)
+    syscall_none(GETPID);
+  t = kget_count() - t;
+
+  kprint("Bench GETPID round trip\t\t\t\t");
+  kprint(itos(t / BENCH_SYSCALLS, c));
+  kprint(" count ticks/op (");
+  kprint(itos(t, c));
+  kprint(" for ");
+  kprint(itos(BENCH_SYSCALLS, c));
+  kprintln(")");
+
+  pls_reset(&plsrunning);
+  set_current_pcb(NULL);
+}
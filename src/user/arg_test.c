@@ -1,8 +1,11 @@
 /**
- * @file quit.c
- * @brief Really simple program who print "Hello from <pid>" and quit
+ * @file arg_test.c
+ * @brief Check, from inside the process, the arguments the kernel gave it
  *
- * This program is mainly here for testing purpose
+ * This program is mainly here for testing purpose. Run it from the shell
+ * as: arg_test arg1 arg2
+ * It prints OK or FAIL for argc and each string of argv, and exits with
+ * FAILNOOB if one is wrong.
  */
 
 #include <stdio.h>
@@ -11,20 +14,43 @@
 #include <process.h>
 #include <string.h>
 
+#define ARG_TEST_ARGC 3
+
 void
 arg_test_main(int argc, char **argv)
 {
-  int             mypid;
-
-  mypid = get_pid();
+  char           *expected[ARG_TEST_ARGC] = { "arg_test", "arg1", "arg2" };
+  int             i, res = OMGROXX;
 
   sleep(800);                   /* To ensure the father get the time to change the arg */
 
-  print((char *) argv);
+  print("Test argc\t\t\t\t\t");
+  if (argc == ARG_TEST_ARGC)
+    print("OK\n");
+  else
+  {
+    print("FAIL: ");
+    printi(argc);
+    printn();
+    res = FAILNOOB;
+  }
+
+  for (i = 0; i < ARG_TEST_ARGC; i++)
+  {
+    print("Test argv[");
+    printi(i);
+    print("]\t\t\t\t\t");
 
-  if (strcmp(get_arg(argv, 1), "arg1") != 0)
-    // || strcmp(argv[1], "arg1") != 0 || strcmp(argv[2], "arg2") != 0)
-    exit(FAILNOOB);
+    if (strcmp(get_arg(argv, i), expected[i]) == 0)
+      print("OK\n");
+    else
+    {
+      print("FAIL: '");
+      print(get_arg(argv, i));
+      print("'\n");
+      res = FAILNOOB;
+    }
+  }
 
-  exit(OMGROXX);
+  exit(res);
 }
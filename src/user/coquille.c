@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <process.h>
 #include <error.h>
+#include <errno.h>
 #include <message.h>
 
 #include "coquille.h"
@@ -20,7 +21,7 @@
 #include "fibonacci.h"
 
 
-char            command_arg[MAX_SHELL_ARG][ARG_SIZE];
+argblock        command_arg;
 
 void
 coquille(void)
@@ -40,18 +41,17 @@ coquille(void)
     printn();
 
     // split the string
-    nb_arg = split_args(buffer, command_arg);
+    nb_arg = split_args(buffer, &command_arg);
 
     if (nb_arg != -1)
     {
       // if the command is exit, exit the shell
-      if (strcmp("exit", command_arg[0]) == 0)
+      if (strcmp("exit", get_arg((char **) &command_arg, 0)) == 0)
         cexit = 1;
       // otherwise create the desirated process
       else
       {
-        pid =
-          fourchette(command_arg[0], BAS_PRI, nb_arg, (char **) command_arg);
+        pid = fourchette_args(&command_arg, BAS_PRI);
         if (pid > 0)
           wait(pid, &status);
         else
@@ -65,37 +65,27 @@ coquille(void)
 }
 
 int
-split_args(char *str, char data[MAX_SHELL_ARG][ARG_SIZE])
+split_args(char *str, argblock * args)
 {
-  int             i = 0, cpt = 0;
   char           *next;
+
+  args->size = ARG_HEADER;
+  args->argc = 0;
   str = trim(str);
 
   while (*str != '\0')
   {
     next = strchr(str, ' ');
     if (next != NULL)
-    {
-      if (i < MAX_SHELL_ARG)
-      {
-        strcpyn(str, data[i], next - str);
-        cpt++;
-      }
-      str = next;
-      str++;
-    }
+      *next++ = '\0';
     else
-    {
       next = strchr(str, '\0');
-      if (i < MAX_SHELL_ARG)
-      {
-        strcpy(str, data[i]);
-        cpt++;
-      }
-      str = next;
-    }
-    i++;
+
+    if (args->argc >= MAX_SHELL_ARG || args_add(args, str) != OMGROXX)
+      return -1;
+
+    str = next;
   }
 
-  return (i <= MAX_SHELL_ARG) ? cpt - 1 : -1;
+  return args->argc - 1;
 }
@@ -19,12 +19,14 @@
 void            coquille(void);
 
  /**
- * \fn int split_args(char *str, char[MAX_SHELL_ARG][MAX_CHAR])
- * \brief Shell program.
+ * \fn int split_args(char *str, argblock *args)
+ * \brief Split a command line in arguments.
  *
- * \param str string to parse and split
- * \param char** array Output array where will be stored the different arguments
+ * \param str string to parse and split, it is modified
+ * \param args Output block where will be stored the different arguments
+ * \return the number of arguments after the name, -1 if there is none or
+ * too many
  */
-int             split_args(char *str, char[MAX_SHELL_ARG][ARG_SIZE]);
+int             split_args(char *str, argblock * args);
 
 #endif //__COQUILLE_H
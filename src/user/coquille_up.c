@@ -39,70 +39,129 @@ chg_prio(int argc, char *argv[])
   exit(0);
 }
 
+/*
+ * The processes copied by ps, too big for its stack with a lot of pcb
+ */
+static psinfo   ps_tab[MAXPCB];
+
 // params: no param
 void
 ps(int argc, char *argv[])
 {
-  int             pid[MAXPCB];
   //char            buf[255];
   //char            num[15];
   int             i, len;
-  pcbinfo         pinf;
-
-  // init the pid list
-  for (i = 0; i < MAXPCB; i++)
-    pid[i] = -1;
+  psinfo         *pinf;
+  schedinfo       sinf;
 
-  len = get_ps(pid);
+  len = get_ps_info(ps_tab, MAXPCB);
 
   print("Process: ");
   printi(len);
   printn();
-  print("PID\tNAME\tSTATE\tPRIO\n");
+  print("PID\tNAME\tSTATE\tPRIO\tRUN(ms)\tWAIT(ms)\tVCSW\tICSW\tMSG\n");
   print("_______________________________\n");
   for (i = 0; i < len; i++)
   {
-    if (pid[i] != -1)
+    pinf = &ps_tab[i];
+    printi(pinf->pid);
+    print("\t");
+    print(pinf->name);
+    print("\t");
+
+    switch (pinf->state)
     {
-		 get_proc_info(pid[i], &pinf);
-      printi(pid[i]);
-      print("\t");
-      print(pinf.name);
-      print("\t");	
+    case READY:
+      print("READY");
+      break;
+    case RUNNING:
+      print("RUNNING");
+      break;
+    case BLOCKED:
+      print("BLOCKED");
+      break;
+    case SLEEPING:
+      print("SLEEPING");
+      break;
+    case WAITING_IO:
+      print("WAITING_IO");
+      break;
+    case DOING_IO:
+      print("DOING_IO");
+      break;
+    case WAITING_PCB:
+      print("WAITING_PCB");
+      break;
+    case WAITING_MSG:
+      print("WAITING_MSG");
+      break;
+    case WAITING_CALL:
+      print("WAITING_CALL");
+      break;
+    case CALLING:
+      print("CALLING");
+      break;
+    case WAITING_REPLY:
+      print("WAITING_REPLY");
+      break;
+    case OMG_ZOMBIE:
+      print("OMG_ZOMBIE");
+      break;
+    }
+    print("\t");
+    printi(pinf->pri);
+    if (pinf->epri != pinf->pri)
+    {
+      print("(");
+      printi(pinf->epri);
+      print(")");
+    }
+    print("\t");
+    printi(pinf->run_time / 1000);
+    print("\t");
+    printi(pinf->wait_time / 1000);
+    print("\t\t");
+    printi(pinf->vol_switch);
+    print("\t");
+    printi(pinf->invol_switch);
+    print("\t");
+    printi(pinf->nb_msg);
+    printn();
+  }
+  print("_______________________________\n");
 
-      switch (pinf.state)
+  /*
+   * The latency histogram, only the non empty buckets
+   */
+  if (get_sched_info(&sinf) == 0)
+  {
+    print("Context switches: ");
+    printi(sinf.switches);
+    print("\nCpu busy (ms): ");
+    printi(sinf.busy_time);
+    print("\tidle (ms): ");
+    printi(sinf.idle_time);
+    print("\nReady to run latency:\n");
+    for (i = 0; i < LAT_BUCKETS; i++)
+    {
+      if (sinf.latency[i] != 0)
       {
-      case READY:
-        print("READY");
-        break;
-      case RUNNING:
-        print("RUNNING");
-        break;
-      case BLOCKED:
-        print("BLOCKED");
-        break;
-      case SLEEPING:
-        print("SLEEPING");
-        break;
-      case WAITING_IO:
-        print("WAITING_IO");
-        break;
-      case DOING_IO:
-        print("DOING_IO");
-        break;
-      case WAITING_PCB:
-        print("WAITING_PCB");
-        break;
-      case OMG_ZOMBIE:
-        print("OMG_ZOMBIE");
-        break;
+        if (i == LAT_BUCKETS - 1)
+        {
+          print("  >= ");
+          printi(1 << i);
+        }
+        else
+        {
+          print("  < ");
+          printi(1 << (i + 1));
+        }
+        print(" us:\t");
+        printi(sinf.latency[i]);
+        printn();
       }
-      print("\t");
-      printi(pinf.pri);
-      printn();
     }
   }
-  print("_______________________________\n");
 
   exit(0);
 }
@@ -168,13 +227,16 @@ proc_info(int argc, char *argv[])
     print("\n\tpriority:\t\t");
     printi(res.pri);
     print("\n\tsupervised processes:\t");
-    for (i = 0; i < MAXPCB; i++)
+    for (i = 0; i < PINFO_SUPERVISED && res.supervised[i] != -1; i++)
     {
-      if (res.supervised[i] != -1)
-      {
-        printi(res.supervised[i]);
-        print(" ");
-      }
+      printi(res.supervised[i]);
+      print(" ");
+    }
+    if (res.nb_supervised > PINFO_SUPERVISED)
+    {
+      print("(");
+      printi(res.nb_supervised);
+      print(" in all)");
     }
     print("\n\tsupervisor process:\t");
     printi(res.supervisor);
@@ -184,6 +246,10 @@ proc_info(int argc, char *argv[])
     printi(res.sleep);
     print("\n\twaiting for process:\t");
     printi(res.waitfor);
+    print("\n\tstack peak/size:\t");
+    printi(res.stack_peak);
+    print("/");
+    printi(res.stack_size);
     //print("\n\tlast error:\t\t");
     //printi(res.error);
     printn();
@@ -13,13 +13,13 @@
 #include "../kernel/ksyscall.h"
 
 /**
- * Send the data to the process 'pid'.
+ * Send the data to the process 'pid' with priority BAS_MPRI.
  * \private
  */
 int
 send(void *data, msg_t tdata, int pid)
 {
-  msg_arg         res = { data, tdata, pid, 0, -1, 0 };
+  msg_arg         res = { data, tdata, pid, BAS_MPRI, -1, 0 };
   return syscall_one((int32_t) & res, SEND);
 }
 
@@ -35,22 +35,15 @@ sendp(void *data, msg_t tdata, int pid, int pri)
 }
 
 /**
- * Receives a message of type 'tdata'.
+ * Receives a message of type 'tdata'. The kernel blocks the process until the
+message comes, and gives it back with the same syscall.
  * \private
  */
 int
 recv(void *data, msg_t tdata, int timeout)
 {
-  int             res2;
   msg_arg         res = { data, tdata, 0, 0, timeout, FTYPE };
-  res2 = syscall_one((int32_t) & res, RECV);
-  while (res2 == NOTFOUND && timeout <= 0)
-  {
-	  sleep(10);
-	  res.timeout = res.timeout - 10;
-    res2 = syscall_one((int32_t) & res, RECV);
-  }
-  return res2;
+  return syscall_one((int32_t) & res, RECV);
 }
 
 /**
@@ -60,12 +53,8 @@ recv(void *data, msg_t tdata, int timeout)
 int
 recv_from_pid(void *data, msg_t tdata, int pid, int timeout)
 {
-  int             res2;
   msg_arg         res = { data, tdata, pid, 0, timeout, FPID };
-  res2 = syscall_one((int32_t) & res, RECV);
-  if (res2 == NOTFOUND)
-    res2 = syscall_one((int32_t) & res, RECV);
-  return res2;
+  return syscall_one((int32_t) & res, RECV);
 }
 
 /**
@@ -75,10 +64,46 @@ recv_from_pid(void *data, msg_t tdata, int pid, int timeout)
 int
 recv_fromp_pri(void *data, msg_t tdata, int pri, int timeout)
 {
-  int             res2;
   msg_arg         res = { data, tdata, 0, pri, timeout, FPRI };
-  res2 = syscall_one((int32_t) & res, RECV);
-  if (res2 == NOTFOUND)
-    res2 = syscall_one((int32_t) & res, RECV);
-  return res2;
+  return syscall_one((int32_t) & res, RECV);
+}
+
+/**
+ * Send the request 'req' to the server 'pid' and wait for its reply.
+ * \private
+ */
+int
+call(int pid, int req, int *reply)
+{
+  return syscall_three(pid, req, (int32_t) reply, CALL);
+}
+
+/**
+ * Reply 'rep' to the client 'client', then wait for the next request.
+ * \private
+ */
+int
+reply_and_wait(int client, int rep, int *req)
+{
+  return syscall_three(client, rep, (int32_t) req, REPLYWAIT);
+}
+
+/**
+ * Take a buffer of MSG_BUF_SIZE bytes from the kernel.
+ * \private
+ */
+void           *
+buf_alloc()
+{
+  return (void *) syscall_none(BUFALLOC);
+}
+
+/**
+ * Give back a buffer of buf_alloc.
+ * \private
+ */
+int
+buf_free(void *buf)
+{
+  return syscall_one((int32_t) buf, BUFFREE);
 }
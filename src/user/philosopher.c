@@ -38,8 +38,8 @@ dining_philosopher(int argc, char *argv[])
 	int             waiter;       //pid waiter
 	int             philos[MAX_PHILO];    //pids philos
 	int             status;
-	char            args[2][ARG_SIZE];
-	char            philos_args[MAX_PHILO][4][ARG_SIZE];
+	argblock        args;
+	argblock        philos_args[MAX_PHILO];
 	int             i, j;
 	char            tmp[10];
 	char            text[200];
@@ -51,17 +51,17 @@ dining_philosopher(int argc, char *argv[])
 		exit(FAILNOOB);
 	}
 
-	if (nb_philo < 2 || loop < 1)
+	if (nb_philo < 2 || nb_philo > MAX_PHILO || loop < 1)
 	{
 		print("Invalid arguments\n");
 		exit(INVARG);
 	}
 
 	// build the arguments for the waiter
-	strcpy("waiter", args[0]);    //prog_name
-	strcpy(get_arg(argv, 1), args[1]);    //nb_philo
+	args_init(&args, "waiter");    //prog_name
+	args_add(&args, get_arg(argv, 1));    //nb_philo
 
-	waiter = fourchette("waiter", BAS_PRI, 2, (char **) args);
+	waiter = fourchette_args(&args, BAS_PRI);
 	if (waiter < 1)
 	{
 		strcpy("Error creating waiter", text);
@@ -75,31 +75,33 @@ dining_philosopher(int argc, char *argv[])
 	for (i = 0; i < nb_philo; i++)
 	{
 		//build arguments for the child
-		strcpy("philosopher", philos_args[i][0]);
-		itos(waiter, philos_args[i][1]);
-		itos(i, philos_args[i][2]); //index of the pid in the philos id array
-		strcpy(get_arg(argv, 2), philos_args[i][3]);        //loop
-		philos[i] =
-			fourchette("philosopher", BAS_PRI, 4, (char **) philos_args[i]);
-		if (philos[i] < 1)
-		{
-			strcpy("Error creating a philosopher", text);
-			strcat(text, " : ");
-			strcat(text, itos(philos[i], tmp));
-			strcat(text, "\n");
-			print(text);
-			//clean up
-			for (j = 0; j < i; j++)
-				kill(philos[j]);
-			kill(waiter);
-			exit(FAILNOOB);
-		}
+		args_init(&philos_args[i], "philosopher");
+		args_add(&philos_args[i], itos(waiter, tmp));
+		args_add(&philos_args[i], itos(i, tmp)); //index of the pid in the philos id array
+		args_add(&philos_args[i], get_arg(argv, 2));        //loop
 	}
-	// wait for the child to end
+
+	// create them all at once
+	i = fourchette_many("philosopher", BAS_PRI, nb_philo, philos_args,
+			nb_philo, philos);
+	if (i < nb_philo)
+	{
+		strcpy("Error creating a philosopher", text);
+		strcat(text, " : ");
+		strcat(text, itos(i < 0 ? i : philos[i], tmp));
+		strcat(text, "\n");
+		print(text);
+		//clean up
+		for (j = 0; j < i; j++)
+			kill(philos[j]);
+		kill(waiter);
+		exit(FAILNOOB);
+	}
+	// wait for the philosophers to end, in any order
 	for (i = 0; i < nb_philo; i++)
-		wait(philos[i], &status);
-	//stop the waiter       
-	send((void *) END, INT_T, waiter);
+		wait_set(philos, nb_philo, &status);
+	//stop the waiter
+	call(waiter, END, &status);
 	wait(waiter, &status);
 	print("THE END\n");
 
@@ -117,6 +119,7 @@ waiter(int argc, char *argv[])  //int nb_philo
 	int             fork[nb_philo], philos[nb_philo];     //fork[i] = 0 means the fork is not available
 
 	int             i, j, code, in, do_packing, end = 0;
+	int             client = -1, reply = 0;
 	int             buf_req[nb_philo];
 	int             buf_phi[nb_philo];    //the waiter will need to buffer the requests that can't be satisfied when he gets the message. At most nb_philo-1 messages can be buffered at the same time. One more and it's a deadlock. 
 	int             fork_taken = 0;      //counts the number of fork taken
@@ -161,9 +164,9 @@ waiter(int argc, char *argv[])  //int nb_philo
 	in = 0;
 	while (!end)
 	{
-		//the waiter waits for a request
-		philo_pid = recv(&code, INT_T, 10000);
-		//print("Timeout\n");
+		//the waiter answers the last request and waits for the next one
+		philo_pid = reply_and_wait(client, reply, &code);
+		client = -1;
 		if (philo_pid < 1)
 			continue;
 
@@ -180,7 +183,12 @@ waiter(int argc, char *argv[])  //int nb_philo
 			else
 				t = right_fork ((philo_id+1)%nb_philo, philo_pid , fork, &fork_taken);
 
-			if (!t)
+			if (t)
+			{
+				client = philo_pid;
+				reply = GO_FOR_IT;
+			}
+			else
 			{
 				//fork taken or only one fork left. In the last case, it can only be taken by a philosopher who already has a fork. Since the left fork are requested first, this is not the case here. We put the request in the buffer
 				buf_req[in] = code;
@@ -191,7 +199,8 @@ waiter(int argc, char *argv[])  //int nb_philo
 
 		else if (code == RELEASE)
 		{
-			print("tess\n");
+			client = philo_pid;
+			reply = FORK_FREE;
 			fork[philo_id] = FORK_FREE;       // release the left fork
 			fork[(philo_id + 1) % nb_philo] = FORK_FREE;      // release the right fork
 			fork_taken -= 2;
@@ -214,7 +223,10 @@ waiter(int argc, char *argv[])  //int nb_philo
 						t = right_fork ((philo_id+1)%nb_philo, philo_pid , fork, &fork_taken);
 
 					if(t)
+					{
+						reply_and_wait(philo_pid, GO_FOR_IT, NULL);
 						do_packing = 1;
+					}
 				}
 
 				if (do_packing)
@@ -231,9 +243,14 @@ waiter(int argc, char *argv[])  //int nb_philo
 			}
 		}
 		else if (code == END)
+		{
+			client = philo_pid;
+			reply = END;
 			end = 1;
+		}
 	}
 
+	reply_and_wait(client, reply, NULL);
 	exit(OMGROXX);
 }
 
@@ -291,23 +308,21 @@ philosopher(int argc, char *argv[])
 		strcat(text, "is hungry\n");
 		print(text);
 
-		if (send((void *) FORK_L, INT_T, waiter_pid) != OMGROXX)
+		if (call(waiter_pid, FORK_L, &mess) != OMGROXX)
 		{
 			print("Failed to send the request for the left fork\n");
 			exit(FAILNOOB);
 		}
-		recv_from_pid(&mess, INT_T, waiter_pid, 10000);
 
 		strcpy(proctext, text);
 		strcat(text, "got left fork\n");
 		print(text);
 
-		if (send((void *) FORK_R, INT_T, waiter_pid) != OMGROXX)
+		if (call(waiter_pid, FORK_R, &mess) != OMGROXX)
 		{
 			print("Failed to send the request for the right fork\n");
 			exit(FAILNOOB);
 		}
-		recv_from_pid(&mess, INT_T, waiter_pid, 10000);
 
 		strcpy(proctext, text);
 		strcat(text, "is eating\n");
@@ -319,7 +334,7 @@ philosopher(int argc, char *argv[])
 		strcat(text, "finished eating\n");
 		print(text);
 
-		send((void *) RELEASE, INT_T, waiter_pid);
+		call(waiter_pid, RELEASE, &mess);
 
 		count++;
 	}
@@ -334,7 +349,6 @@ bool left_fork(int index,int philo_pid, int* fork, int* fork_taken, int num_phil
 		//fork free and at least two fork remaining, go for it
 		fork[index] = FORK_TAKEN;
 		(*fork_taken) ++;
-		send((void *) GO_FOR_IT, INT_T, philo_pid);
 		return TRUE;
 	}
 	//this fork is not available/shouldn't be taken
@@ -348,7 +362,6 @@ bool right_fork(int index, int philo_pid, int* fork, int* fork_taken){
 		// no need to check for fork_taken because a process requesting its right fork already has the left one
 		fork[index] = FORK_TAKEN;
 		(*fork_taken) ++;
-		send((void *) GO_FOR_IT, INT_T, philo_pid);
 		return TRUE;
 	}
 	return FALSE;
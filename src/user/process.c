@@ -13,13 +13,68 @@
 #include "../kernel/ksyscall.h"
 
  /**
- * Return the argument i from the char* array of arguments.
+ * Return the argument i from the char* array of arguments. argv is the
+block of arguments given by the kernel: each argument is after the length of
+the previous one.
  * \private
  */
 char           *
 get_arg(char *argv[], int i)
 {
-  return (char *) argv + (i * ARG_SIZE * sizeof(char));
+  argblock       *args = (argblock *) argv;
+  char           *s;
+
+  if (args == NULL || i < 0 || i >= args->argc)
+    return "";
+
+  for (s = args->data; i > 0; i--)
+    s += (unsigned char) s[0] + 2;
+
+  return s + 1;
+}
+
+ /**
+ * Start a block of arguments with the name of the program.
+ * \private
+ */
+int
+args_init(argblock * args, char *name)
+{
+  if (args == NULL)
+    return NULLPTR;
+
+  args->size = ARG_HEADER;
+  args->argc = 0;
+
+  return args_add(args, name);
+}
+
+ /**
+ * Add an argument at the end of a block of arguments.
+ * \private
+ */
+int
+args_add(argblock * args, char *arg)
+{
+  int             l;
+  char           *d;
+
+  if (args == NULL || arg == NULL)
+    return NULLPTR;
+
+  l = strlen(arg);
+
+  if (l > 255 || args->size + l + 2 > ARG_BLOCK)
+    return OUTOMEM;
+
+  d = (char *) args + args->size;
+  d[0] = l;
+  strcpy(arg, d + 1);
+
+  args->size += l + 2;
+  args->argc++;
+
+  return OMGROXX;
 }
 
  /**
@@ -88,6 +143,34 @@ wait(int pid, int *status)
   return r;
 }
 
+ /**
+ * Wait for any child to exit and set the status variable with its exit code.
+ * \private
+ */
+int
+wait_any(int *status)
+{
+  return wait_set(NULL, 0, status);
+}
+
+ /**
+ * Wait for one of the children of the array to exit and set the status
+variable with its exit code. The kernel gives the pid back when the child
+exits, a second call is only needed if the process was woken up for an other
+reason.
+ * \private
+ */
+int
+wait_set(int *pids, int n, int *status)
+{
+  int             r;
+  do
+    r = syscall_three((int32_t) pids, n, (int32_t) status, WAITANY);
+  while (r == FAILNOOB);
+
+  return r;
+}
+
  /**
  * Creates a new process with the program identified by its name 'name'. The
 program must be stored in the program list of the OS.
@@ -99,6 +182,37 @@ fourchette(char *name, int prio, int argc, char *argv[])
   return syscall_three(prio, argc, (int32_t) argv, FOURCHETTE);
 }
 
+ /**
+ * Creates a new process with a block of arguments. The first argument is the
+name of the program.
+ * \private
+ */
+int
+fourchette_args(argblock * args, int prio)
+{
+  return syscall_two((int32_t) args, prio, FOURCHETTEARGS);
+}
+
+ /**
+ * Creates n processes of the same program with a single syscall.
+ * \private
+ */
+int
+fourchette_many(char *name, int prio, int n, argblock * args, int nargs,
+                int *pids)
+{
+  spawninfo       s;
+
+  s.name = name;
+  s.prio = prio;
+  s.n = n;
+  s.args = args;
+  s.nargs = nargs;
+  s.pids = pids;
+
+  return syscall_one((int32_t) & s, FOURCHETTEMANY);
+}
+
  /**
  * Fill the pcb_info structure given in parameter with the pcb information. Only
 not critical information is given to the user.
@@ -110,6 +224,17 @@ get_proc_info(int pid, pcbinfo * res)
   return syscall_two(pid, (int32_t) res, GETPINFO);
 }
 
+ /**
+ * Fill the schedinfo structure given in parameter with the statistics of the
+scheduler.
+ * \private
+ */
+int
+get_sched_info(schedinfo * res)
+{
+  return syscall_one((int32_t) res, GETSINFO);
+}
+
  /**
  * Changes the priority of the process from the old one to the new priority 'prio'.
  * \private
@@ -139,3 +264,13 @@ get_ps(int *pid)
 {
   return syscall_one((int32_t) pid, GETALLPID);
 }
+
+ /**
+ * Fill the psinfo array with all the processes, in one syscall.
+ * \private
+ */
+int
+get_ps_info(psinfo * res, int max)
+{
+  return syscall_two((int32_t) res, max, GETPSINFO);
+}
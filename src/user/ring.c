@@ -46,7 +46,7 @@ ring(int argc, char *argv[])
     int             nb_proc;
     int             loop;
     int             status;
-    char            args[3][ARG_SIZE];
+    argblock        args;
 
     if (argc < 3)
     {
@@ -78,10 +78,10 @@ ring(int argc, char *argv[])
     strcat(text, "loop(s)\n");
     print(text);
 
-    // fill the argument array for the childs
-    strcpy("ring", args[0]);
-    itos(get_pid(), args[1]);
-    strcpy(get_arg(argv, 2), args[2]);
+    // fill the argument block for the childs
+    args_init(&args, "ring");
+    args_add(&args, itos(get_pid(), tmp));
+    args_add(&args, get_arg(argv, 2));
 
 /*	strcpy("Args: progname->", text);
 	strcat(text, args[0]);
@@ -92,19 +92,19 @@ ring(int argc, char *argv[])
 	strcat(text, "\n");
 	print(text);
 */
-    // creating the children
-    for (i = 0; i < nb_proc; i++)
+    // creating all the children at once, with the same arguments
+    i = fourchette_many("ring", MAX_PRI, nb_proc, &args, 1, pid);
+    if (i < nb_proc)
     {
-      pid[i] = fourchette("ring", MAX_PRI, 3, (char **) args);
-      if (pid[i] < 1)
-      {
-        strcpy("Error creating proc_", text);
-        strcat(text, itos(i, tmp));
-        strcat(text, " : ");
-        strcat(text, itos(pid[i], tmp));
-        strcat(text, "\n");
-        print(text);
-      }
+      strcpy("Error creating proc_", text);
+      strcat(text, itos(i, tmp));
+      strcat(text, " : ");
+      strcat(text, itos(i < 0 ? i : pid[i], tmp));
+      strcat(text, "\n");
+      print(text);
+
+      // the ring is made of the children actually started
+      nb_proc = i < 0 ? 0 : i;
     }
 
     // data to send to all the children
@@ -120,7 +120,10 @@ ring(int argc, char *argv[])
 
     for (i = 0; i < nb_proc; i++)
     {
-      wait(pid[i], &status);
+      // no child left: status was not set
+      if (wait_any(&status) < 0)
+        break;
+
       if (status != OMGROXX)
         print("ERROR PROCESS");
     }
@@ -133,8 +136,8 @@ ring(int argc, char *argv[])
     int             res;
     int             first = -1, pid_next = -1, pid_prev = -1;
     char            prog[20];
-    char            mess[10];
-    char            rcv[10];
+    char           *mess;
+    char           *rcv;
 
     strcpy(get_arg(argv, 0), prog);
     pidmain = stoi(get_arg(argv, 1));
@@ -197,11 +200,18 @@ ring(int argc, char *argv[])
     for (i = 0; i < loop; i++)
     {
       // if we are the first child, send then receive
+      // the message goes around in a buffer of the kernel, never copied
       if (first == 0)
       {
+        mess = buf_alloc();
+        if (mess == NULL)
+        {
+          print("FAIL: no message buffer\n");
+          exit(OUTOMEM);
+        }
+
         strcpy("Hello_", mess);
         strcat(mess, itos(i, tmp));
-        send(mess, CHAR_PTR, pid_next);
 
         strcpy(proctext, text);
         strcat(text, "sent '");
@@ -209,11 +219,11 @@ ring(int argc, char *argv[])
         strcat(text, "' to Process no_");
         strcat(text, itos(pid_next, tmp));
         strcat(text, "\n");
-        print(text);
 
-        strcpy("", rcv);
+        send(mess, BUF_T, pid_next);
+        print(text);
 
-        res = recv_from_pid((char *) rcv, CHAR_PTR, pid_prev, 5000);
+        res = recv_from_pid(&rcv, BUF_T, pid_prev, 5000);
         if (res != pid_prev)
         {
           strcpy("FAIL4", text);
@@ -231,13 +241,12 @@ ring(int argc, char *argv[])
         strcat(text, "\n");
         print(text);
 
+        buf_free(rcv);
       }
       // if not, receive then send
       else
       {
-        strcpy("", rcv);
-
-        res = recv_from_pid((char *) rcv, CHAR_PTR, pid_prev, 5000);
+        res = recv_from_pid(&rcv, BUF_T, pid_prev, 5000);
         if (res != pid_prev)
         {
           strcpy("FAIL5", text);
@@ -255,14 +264,15 @@ ring(int argc, char *argv[])
         strcat(text, "\n");
         print(text);
 
-        send(rcv, CHAR_PTR, pid_next);
-
         strcpy(proctext, text);
         strcat(text, "sent '");
         strcat(text, rcv);
         strcat(text, "' to Process no_");
         strcat(text, itos(pid_next, tmp));
         strcat(text, "\n");
+
+        // the buffer is the next one's now
+        send(rcv, BUF_T, pid_next);
         print(text);
 
       }
@@ -22,7 +22,7 @@ scroll(int argc, char *argv[])
 {
   char            buf[255];
   char            screen[MALTA_SIZE + 1];
-  int             len, pos_space, sleept, j;
+  int             len, pos_space, sleept;
   char           *str = get_arg(argv, 1);
 
   strcpy(str, buf);
@@ -48,7 +48,6 @@ scroll(int argc, char *argv[])
 
     pos_space = (pos_space) ? pos_space - 1 : len;
 
-    j = 0;
     sleep(sleept);
   }
 
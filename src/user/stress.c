@@ -0,0 +1,124 @@
+/**
+ * \file stress.c
+ * \brief Stress user program.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <process.h>
+#include <errno.h>
+
+#include "stress.h"
+
+int             stress_pid[MAXPCB];
+
+// params: int loop -> main program
+// params: int loop -> child programs
+
+/**
+ * Program that creates as many processes as the system can hold, and
+ * prints the cost of the creations and of the scheduling of all of them.
+ * The children have a lower priority, so that they run only when all are
+ * created. Each one sleeps loop times, then exits.
+ * \private
+ */
+void
+stress(int argc, char *argv[])
+{
+  int             i, n, loop, pri, status;
+  unsigned int    run, switches, busy;
+  pcbinfo         pcbi;
+  schedinfo       sinf;
+  char            tmp[12];
+  argblock        args;
+
+  get_proc_info(get_pid(), &pcbi);
+  pri = pcbi.pri;
+  run = pcbi.run_time;
+  get_proc_info(pcbi.supervisor, &pcbi);
+
+  // if the supervisor process is stress, case child
+  if (strcmp(pcbi.name, "stress") == 0)
+  {
+    loop = stoi(get_arg(argv, 1));
+
+    for (i = 0; i < loop; i++)
+      sleep(1);
+
+    exit(OMGROXX);
+  }
+
+  loop = STRESS_LOOP;
+
+  if (argc > 1)
+    loop = stoi(get_arg(argv, 1));
+
+  if (loop < 0)
+    loop = 0;
+
+  if (pri > MIN_PRI)
+    pri--;
+
+  args_init(&args, "stress");
+  args_add(&args, itos(loop, tmp));
+
+  // creating the children, until there is no pcb left
+  for (n = 0; n < MAXPCB; n++)
+  {
+    stress_pid[n] = fourchette_args(&args, pri);
+
+    if (stress_pid[n] < 1)
+      break;
+  }
+
+  get_proc_info(get_pid(), &pcbi);
+  run = pcbi.run_time - run;
+
+  print("Created ");
+  printi(n);
+  print(" processes (MAXPCB ");
+  printi(MAXPCB);
+  print(") in ");
+  printi(run);
+  print(" us");
+  if (n > 0)
+  {
+    print(", ");
+    printi(run / n);
+    print(" us each");
+  }
+  printn();
+
+  // let them all run, sleep and exit
+  get_sched_info(&sinf);
+  switches = sinf.switches;
+  busy = sinf.busy_time;
+
+  for (i = 0; i < n; i++)
+  {
+    wait_any(&status);
+    if (status != OMGROXX)
+      print("ERROR PROCESS\n");
+  }
+
+  get_sched_info(&sinf);
+  switches = sinf.switches - switches;
+  busy = sinf.busy_time - busy;
+
+  print("Ran them ");
+  printi(loop);
+  print(" time(s): ");
+  printi(switches);
+  print(" switches, ");
+  printi(busy);
+  print(" ms busy");
+  if (switches > 0)
+  {
+    print(", ");
+    printi(busy * 1000 / switches);
+    print(" us per switch");
+  }
+  printn();
+
+  exit(0);
+}
@@ -0,0 +1,22 @@
+/**
+ * \file stress.h
+ * \brief Stress user program.
+ */
+
+#ifndef __STRESS_H
+#define __STRESS_H
+
+/**
+ * Number of times each child goes to sleep, if not given
+ */
+#define STRESS_LOOP 10
+
+/**
+ * Program that creates as many processes as the system can hold, and
+ * prints the cost of the creations and of the scheduling of all of them.
+ * \param argc the number of arguments
+ * \param argv the arguments: the number of times each child sleeps
+ */
+void            stress(int argc, char *argv[]);
+
+#endif //__STRESS_H
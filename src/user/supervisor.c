@@ -108,6 +108,23 @@ Rand32(void)
   return (ul);
 }
 
+/**
+ * Create the child number i
+ * \private
+ */
+int
+supervisor_child(int i)
+{
+  argblock        args;
+  char            num[12];
+
+  args_init(&args, "supervisor");
+  args_add(&args, itos(get_pid(), num));
+  args_add(&args, itos(i, num));
+
+  return fourchette_args(&args, BAS_PRI);
+}
+
 /**
  * Test the supervision mechanisms (exit with a return value
  * and undersand what happenned).
@@ -119,7 +136,6 @@ supervisor(int argc, char *argv[])
   int             i, j;
   int             pid[MAX_SUP];
   pcbinfo         pcbi;
-  char            args[MAX_SUP][3][ARG_SIZE];   //nb_sup-nb_arg-arg_size
   char            buffer[255];
   char            num[3];
 
@@ -153,12 +169,8 @@ supervisor(int argc, char *argv[])
     // creating the children
     for (i = 0; i < nb_proc; i++)
     {
-      strcpy("supervisor", args[i][0]);
-      itos(get_pid(), args[i][1]);
-      itos(i, args[i][2]);
-
       lives[i] = nb_lives;
-      pid[i] = fourchette("supervisor", BAS_PRI, 3, (char **) args[i]);
+      pid[i] = supervisor_child(i);
     }
 
     // wait for them and restard the dead ones
@@ -183,7 +195,7 @@ supervisor(int argc, char *argv[])
             strcat(buffer, " lives left)\n");
             print(buffer);
 
-            pid[i] = fourchette("supervisor", BAS_PRI, 3, (char **) args[i]);
+            pid[i] = supervisor_child(i);
 
 				if (pid[i] < 1)
 				{